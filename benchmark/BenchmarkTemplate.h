@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_BENCHMARKTEMPLATE_H
+#define GOLEM_BENCHMARKTEMPLATE_H
+
+#include "ChcSystem.h"
+
+#include "osmt_terms.h"
+#include "osmt_solver.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Generators of synthetic inputs whose size is controlled by a single parameter.
+ * All formulas are satisfied by the model assigning zero to every variable.
+ */
+class FormulaGenerator {
+    ArithLogic & logic;
+    SRef sort;
+
+public:
+    FormulaGenerator(ArithLogic & logic, SRef sort) : logic(logic), sort(sort) {}
+
+    PTRef constant(int value) const { return logic.mkConst(sort, FastRational(value)); }
+
+    // Variables named <prefix><index><suffix>, e.g., with suffix "##0" for variables versioned by TimeMachine
+    std::vector<PTRef> makeVars(std::string const & prefix, std::size_t count, std::string const & suffix = "") const {
+        std::vector<PTRef> vars;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string name = prefix + std::to_string(i) + suffix;
+            vars.push_back(logic.mkVar(sort, name.c_str()));
+        }
+        return vars;
+    }
+
+    // c * x_{i+1} >= x_i and c * x_{i+1} <= x_i + c - 1; for c > 1 integer projection introduces divisibility constraints
+    PTRef scaledChain(std::vector<PTRef> const & vars, int coefficient = 1) const {
+        vec<PTRef> conjuncts;
+        for (std::size_t i = 0; i + 1 < vars.size(); ++i) {
+            PTRef scaled = logic.mkTimes(constant(coefficient), vars[i + 1]);
+            conjuncts.push(logic.mkGeq(scaled, vars[i]));
+            conjuncts.push(logic.mkLeq(scaled, logic.mkPlus(vars[i], constant(coefficient - 1))));
+        }
+        return logic.mkAnd(std::move(conjuncts));
+    }
+
+    // Nested negations of alternating conjunctions and disjunctions over bounds on the variables
+    PTRef nestedBoolean(std::vector<PTRef> const & vars) const {
+        PTRef fla = logic.getTerm_true();
+        for (std::size_t i = 0; i + 1 < vars.size(); ++i) {
+            PTRef atom = logic.mkLeq(vars[i], vars[i + 1]);
+            fla = i % 2 == 0 ? logic.mkNot(logic.mkAnd(fla, atom)) : logic.mkNot(logic.mkOr(fla, atom));
+        }
+        return fla;
+    }
+
+    std::unique_ptr<Model> zeroModel(std::vector<PTRef> const & vars) const {
+        ModelBuilder builder(logic);
+        for (PTRef var : vars) {
+            builder.addVarValue(var, constant(0));
+        }
+        return builder.build();
+    }
+};
+
+/*
+ * Chain of predicates P_0 -> P_1 -> ... -> P_n with a self-loop on P_n and a query from P_n.
+ * Every edge of the chain is present 'parallelEdges' times with different constraints;
+ * heads have non-variable arguments, so the system needs normalization.
+ */
+inline ChcSystem chainSystem(ArithLogic & logic, std::size_t length, std::size_t parallelEdges = 1) {
+    ChcSystem system;
+    SRef sort = logic.getSort_int();
+    PTRef x = logic.mkVar(sort, "x");
+    std::vector<SymRef> predicates;
+    for (std::size_t i = 0; i <= length; ++i) {
+        std::string name = "P" + std::to_string(i);
+        predicates.push_back(logic.declareFun(name, logic.getSort_bool(), {sort}));
+        system.addUninterpretedPredicate(predicates.back());
+    }
+    auto pred = [&](std::size_t index, PTRef arg) {
+        return UninterpretedPredicate{logic.mkUninterpFun(predicates[index], {arg})};
+    };
+    PTRef zero = logic.getTerm_IntZero();
+    PTRef one = logic.getTerm_IntOne();
+    system.addClause(ChcHead{pred(0, zero)}, ChcBody{{logic.getTerm_true()}, {}});
+    for (std::size_t i = 0; i < length; ++i) {
+        for (std::size_t j = 0; j < parallelEdges; ++j) {
+            PTRef shifted = logic.mkPlus(x, logic.mkIntConst(static_cast<int>(j + 1)));
+            system.addClause(ChcHead{pred(i + 1, shifted)}, ChcBody{{logic.mkGeq(x, zero)}, {pred(i, x)}});
+        }
+    }
+    system.addClause(ChcHead{pred(length, logic.mkPlus(x, one))}, ChcBody{{logic.getTerm_true()}, {pred(length, x)}});
+    system.addClause(ChcHead{UninterpretedPredicate{logic.getTerm_false()}}, ChcBody{{logic.mkLt(x, zero)}, {pred(length, x)}});
+    return system;
+}
+
+// Sizes of the generated inputs, shared by all benchmarks
+inline void formulaSizes(benchmark::internal::Benchmark * bench) {
+    bench->RangeMultiplier(4)->Range(16, 1024);
+}
+
+inline void graphSizes(benchmark::internal::Benchmark * bench) {
+    bench->RangeMultiplier(4)->Range(4, 256);
+}
+
+#endif //GOLEM_BENCHMARKTEMPLATE_H
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "BenchmarkTemplate.h"
+
+#include "ModelBasedProjection.h"
+#include "QuantifierElimination.h"
+
+namespace {
+// Projects a chain of n variables to its end points; the chain uses the given coefficient on the eliminated variables
+void projectChain(benchmark::State & state, opensmt::Logic_t logicType, int coefficient) {
+    ArithLogic logic{logicType};
+    SRef sort = logicType == opensmt::Logic_t::QF_LIA ? logic.getSort_int() : logic.getSort_real();
+    FormulaGenerator generator(logic, sort);
+    auto vars = generator.makeVars("x", static_cast<std::size_t>(state.range(0)));
+    PTRef fla = generator.scaledChain(vars, coefficient);
+    vec<PTRef> toEliminate;
+    for (std::size_t i = 1; i + 1 < vars.size(); ++i) {
+        toEliminate.push(vars[i]);
+    }
+    auto model = generator.zeroModel(vars);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ModelBasedProjection(logic).project(fla, toEliminate, *model));
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+void BM_MBP_LRA(benchmark::State & state) { projectChain(state, opensmt::Logic_t::QF_LRA, 1); }
+BENCHMARK(BM_MBP_LRA)->Apply(formulaSizes)->Complexity();
+
+void BM_MBP_LIA(benchmark::State & state) { projectChain(state, opensmt::Logic_t::QF_LIA, 1); }
+BENCHMARK(BM_MBP_LIA)->Apply(formulaSizes)->Complexity();
+
+void BM_MBP_LIA_divisibility(benchmark::State & state) { projectChain(state, opensmt::Logic_t::QF_LIA, 2); }
+BENCHMARK(BM_MBP_LIA_divisibility)->Apply(formulaSizes)->Complexity();
+
+void BM_QE_eliminate(benchmark::State & state) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    FormulaGenerator generator(logic, logic.getSort_real());
+    auto vars = generator.makeVars("x", static_cast<std::size_t>(state.range(0)));
+    PTRef fla = generator.scaledChain(vars);
+    vec<PTRef> toEliminate;
+    for (std::size_t i = 1; i + 1 < vars.size(); ++i) {
+        toEliminate.push(vars[i]);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(QuantifierElimination(logic).eliminate(fla, toEliminate));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_QE_eliminate)->Apply(formulaSizes)->Complexity();
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "BenchmarkTemplate.h"
+
+#include "TermUtils.h"
+
+namespace {
+void BM_TimeMachine_sendFlaThroughTime(benchmark::State & state) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    FormulaGenerator generator(logic, logic.getSort_real());
+    auto vars = generator.makeVars("x", static_cast<std::size_t>(state.range(0)), "##0");
+    PTRef fla = generator.scaledChain(vars);
+    TimeMachine timeMachine(logic);
+    int steps = 0;
+    for (auto _ : state) {
+        // Different distance in each iteration, so the result is not a term built in previous iterations
+        benchmark::DoNotOptimize(timeMachine.sendFlaThroughTime(fla, ++steps));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_TimeMachine_sendFlaThroughTime)->Apply(formulaSizes)->Complexity();
+
+void BM_VersionManager_baseFormulaToSource(benchmark::State & state) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    FormulaGenerator generator(logic, logic.getSort_real());
+    auto vars = generator.makeVars("x#", static_cast<std::size_t>(state.range(0)));
+    PTRef fla = generator.scaledChain(vars);
+    VersionManager manager(logic);
+    unsigned instance = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.baseFormulaToSource(fla, instance++));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_VersionManager_baseFormulaToSource)->Apply(formulaSizes)->Complexity();
+
+void BM_TermUtils_toNNF(benchmark::State & state) {
+    ArithLogic logic{opensmt::Logic_t::QF_LRA};
+    FormulaGenerator generator(logic, logic.getSort_real());
+    auto vars = generator.makeVars("x", static_cast<std::size_t>(state.range(0)));
+    PTRef fla = generator.nestedBoolean(vars);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(TermUtils(logic).toNNF(fla));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_TermUtils_toNNF)->Apply(formulaSizes)->Complexity();
+}
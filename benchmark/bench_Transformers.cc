@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "BenchmarkTemplate.h"
+
+#include "Normalizer.h"
+#include "graph/ChcGraphBuilder.h"
+#include "transformers/NonLoopEliminator.h"
+#include "transformers/SimpleChainSummarizer.h"
+
+namespace {
+void BM_Normalizer_normalize(benchmark::State & state) {
+    ArithLogic logic{opensmt::Logic_t::QF_LIA};
+    auto system = chainSystem(logic, static_cast<std::size_t>(state.range(0)), 2);
+    for (auto _ : state) {
+        auto normalized = Normalizer(logic).normalize(system);
+        benchmark::DoNotOptimize(normalized.normalizedSystem);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Normalizer_normalize)->Apply(graphSizes)->Complexity();
+
+// Runs the transformation on a fresh copy of the graph in each iteration; copying is not measured
+template<typename TMakeTransformer>
+void transformChain(benchmark::State & state, std::size_t parallelEdges, TMakeTransformer makeTransformer) {
+    ArithLogic logic{opensmt::Logic_t::QF_LIA};
+    auto system = chainSystem(logic, static_cast<std::size_t>(state.range(0)), parallelEdges);
+    auto graph = ChcGraphBuilder(logic).buildGraph(Normalizer(logic).normalize(system));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = std::make_unique<ChcDirectedHyperGraph>(*graph);
+        state.ResumeTiming();
+        auto result = makeTransformer(logic)->transform(std::move(copy));
+        benchmark::DoNotOptimize(result.first);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+void BM_SimpleChainSummarizer(benchmark::State & state) {
+    transformChain(state, 1, [](Logic & logic) { return std::make_unique<SimpleChainSummarizer>(logic); });
+}
+BENCHMARK(BM_SimpleChainSummarizer)->Apply(graphSizes)->Complexity();
+
+void BM_NonLoopEliminator(benchmark::State & state) {
+    transformChain(state, 2, [](Logic &) { return std::make_unique<NonLoopEliminator>(); });
+}
+BENCHMARK(BM_NonLoopEliminator)->Apply(graphSizes)->Complexity();
+}
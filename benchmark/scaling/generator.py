@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+#
+# SPDX-License-Identifier: MIT
+#
+"""
+Generator of parametric CHC benchmarks in the CHC-COMP dialect of SMT-LIB.
+
+Every family takes a size parameter controlling the difficulty and comes in a safe (sat) and an unsafe (unsat)
+variant, over integers (QF_LIA) or reals (QF_LRA).
+The shape of the system (transition system, chain of transition systems, linear, nonlinear) is recorded so that
+the harness can select the applicable engines.
+
+Usage: generator.py --output <dir> [--sizes 4 16 64] [--families counter nested ...] [--logics QF_LIA QF_LRA]
+"""
+
+import argparse
+import json
+import os
+
+
+class Writer:
+    def __init__(self, logic):
+        self.logic = logic
+        self.sort = 'Int' if logic == 'QF_LIA' else 'Real'
+        self.lines = ['(set-logic HORN)']
+
+    def num(self, value):
+        text = str(abs(value)) if self.sort == 'Int' else '{}.0'.format(abs(value))
+        return text if value >= 0 else '(- {})'.format(text)
+
+    def declare(self, name, arity):
+        self.lines.append('(declare-fun {} ({}) Bool)'.format(name, ' '.join([self.sort] * arity)))
+
+    def clause(self, variables, body, head):
+        conjunction = body[0] if len(body) == 1 else '(and {})'.format(' '.join(body))
+        if variables:
+            bound = ' '.join('({} {})'.format(var, self.sort) for var in variables)
+            self.lines.append('(assert (forall ({}) (=> {} {})))'.format(bound, conjunction, head))
+        else:
+            self.lines.append('(assert (=> {} {}))'.format(conjunction, head))
+
+    def text(self):
+        return '\n'.join(self.lines + ['(check-sat)', '(exit)']) + '\n'
+
+
+def counter(w, n, safe):
+    """Single loop counting to n"""
+    w.declare('L', 1)
+    w.clause(['x'], ['(= x {})'.format(w.num(0))], '(L x)')
+    w.clause(['x', 'xp'], ['(L x)', '(< x {})'.format(w.num(n)), '(= xp (+ x {}))'.format(w.num(1))], '(L xp)')
+    query = '(> x {})'.format(w.num(n)) if safe else '(= x {})'.format(w.num(n))
+    w.clause(['x'], ['(L x)', query], 'false')
+    return 'transition-system'
+
+
+def sequential(w, k, safe):
+    """k sequential loops, the i-th one counting up to 10 * i"""
+    for i in range(1, k + 1):
+        w.declare('L{}'.format(i), 1)
+    w.clause(['x'], ['(= x {})'.format(w.num(0))], '(L1 x)')
+    for i in range(1, k + 1):
+        bound = w.num(10 * i)
+        w.clause(['x', 'xp'], ['(L{} x)'.format(i), '(< x {})'.format(bound), '(= xp (+ x {}))'.format(w.num(1))],
+                 '(L{} xp)'.format(i))
+        if i < k:
+            w.clause(['x'], ['(L{} x)'.format(i), '(>= x {})'.format(bound)], '(L{} x)'.format(i + 1))
+    query = '(> x {})'.format(w.num(10 * k)) if safe else '(= x {})'.format(w.num(10 * k))
+    w.clause(['x'], ['(L{} x)'.format(k), query], 'false')
+    return 'transition-system-chain'
+
+
+def nested(w, n, safe):
+    """Outer loop up to n, inner loop up to the outer counter, s counts the inner iterations"""
+    w.declare('Outer', 2)
+    w.declare('Inner', 3)
+    zero, one = w.num(0), w.num(1)
+    w.clause(['i', 's'], ['(= i {})'.format(zero), '(= s {})'.format(zero)], '(Outer i s)')
+    w.clause(['i', 's', 'j'], ['(Outer i s)', '(< i {})'.format(w.num(n)), '(= j {})'.format(zero)], '(Inner i j s)')
+    w.clause(['i', 'j', 's', 'jp', 'sp'],
+             ['(Inner i j s)', '(< j i)', '(= jp (+ j {}))'.format(one), '(= sp (+ s {}))'.format(one)], '(Inner i jp sp)')
+    w.clause(['i', 'j', 's', 'ip'], ['(Inner i j s)', '(>= j i)', '(= ip (+ i {}))'.format(one)], '(Outer ip s)')
+    if safe:
+        w.clause(['i', 's'], ['(Outer i s)', '(< s {})'.format(zero)], 'false')
+    else:
+        w.clause(['i', 's'], ['(Outer i s)', '(>= i {})'.format(w.num(n)), '(= s {})'.format(w.num(n * (n - 1) // 2))],
+                 'false')
+    return 'linear'
+
+
+def multilocation(w, n, safe):
+    """Cycle of n locations, every step branches between incrementing x and incrementing y"""
+    for i in range(n):
+        w.declare('L{}'.format(i), 2)
+    zero, one = w.num(0), w.num(1)
+    w.clause(['x', 'y'], ['(= x {})'.format(zero), '(= y {})'.format(zero)], '(L0 x y)')
+    for i in range(n):
+        target = '(L{} {{}} {{}})'.format((i + 1) % n)
+        w.clause(['x', 'y', 'xp'], ['(L{} x y)'.format(i), '(= xp (+ x {}))'.format(one)], target.format('xp', 'y'))
+        w.clause(['x', 'y', 'yp'], ['(L{} x y)'.format(i), '(= yp (+ y {}))'.format(one)], target.format('x', 'yp'))
+    query = '(< (+ x y) {})'.format(zero) if safe else '(= (+ x y) {})'.format(w.num(n))
+    w.clause(['x', 'y'], ['(L0 x y)', query], 'false')
+    return 'linear'
+
+
+def fibonacci(w, n, safe):
+    """Recursive Fibonacci; the unsafe variant asks for the exact value of fib(n)"""
+    w.declare('Fib', 2)
+    zero, one, two = w.num(0), w.num(1), w.num(2)
+    w.clause(['n', 'r'], ['(<= {} n)'.format(zero), '(<= n {})'.format(one), '(= r n)'], '(Fib n r)')
+    w.clause(['n', 'r', 'm', 'a', 'k', 'b'],
+             ['(<= {} n)'.format(two), '(= m (- n {}))'.format(one), '(Fib m a)', '(= k (- n {}))'.format(two),
+              '(Fib k b)', '(= r (+ a b))'], '(Fib n r)')
+    if safe:
+        w.clause(['n', 'r'], ['(Fib n r)', '(< r {})'.format(zero)], 'false')
+    else:
+        a, b = 0, 1
+        for _ in range(n):
+            a, b = b, a + b
+        w.clause(['n', 'r'], ['(Fib n r)', '(= n {})'.format(w.num(n)), '(= r {})'.format(w.num(a))], 'false')
+    return 'nonlinear'
+
+
+FAMILIES = {
+    'counter': counter,
+    'sequential': sequential,
+    'nested': nested,
+    'multilocation': multilocation,
+    'fibonacci': fibonacci,
+}
+
+LOGICS = ['QF_LIA', 'QF_LRA']
+
+
+def generate(output, families, sizes, logics):
+    """Writes the benchmarks and an index.json describing them; returns the index"""
+    os.makedirs(output, exist_ok=True)
+    index = []
+    for family in families:
+        for logic in logics:
+            for size in sizes:
+                for safe in (True, False):
+                    writer = Writer(logic)
+                    shape = FAMILIES[family](writer, size, safe)
+                    name = '{}_{}_{}_{}.smt2'.format(family, logic, size, 'safe' if safe else 'unsafe')
+                    with open(os.path.join(output, name), 'w') as out:
+                        out.write(writer.text())
+                    index.append({'file': name, 'family': family, 'logic': logic, 'size': size, 'shape': shape,
+                                  'expected': 'sat' if safe else 'unsat'})
+    with open(os.path.join(output, 'index.json'), 'w') as out:
+        json.dump(index, out, indent=2)
+    return index
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate parametric CHC benchmarks')
+    parser.add_argument('--output', required=True, help='output directory')
+    parser.add_argument('--sizes', type=int, nargs='+', default=[2, 4, 8, 16])
+    parser.add_argument('--families', nargs='+', choices=sorted(FAMILIES), default=sorted(FAMILIES))
+    parser.add_argument('--logics', nargs='+', choices=LOGICS, default=LOGICS)
+    args = parser.parse_args()
+    index = generate(args.output, args.families, args.sizes, args.logics)
+    print('Generated {} benchmarks in {}'.format(len(index), args.output))
+
+
+if __name__ == '__main__':
+    main()
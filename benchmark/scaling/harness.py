@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+#
+# SPDX-License-Identifier: MIT
+#
+"""
+Runs every applicable Golem engine on benchmarks produced by generator.py and records time, memory and answer.
+
+The list of engines and the class of systems each of them supports are read from the help message of Golem.
+Results are written as JSON; if a baseline (a previous result file) is given, answers that differ from the baseline
+and runs slower than the baseline by more than the given factor are reported, and the exit code is non-zero.
+
+Usage: harness.py --golem <path> --benchmarks <dir> --output results.json [--baseline old.json] [--timeout 60]
+"""
+
+import argparse
+import json
+import os
+import re
+import signal
+import subprocess
+import sys
+import time
+
+# Shapes of systems (as recorded by the generator) supported by each class of engines
+SUPPORTED_SHAPES = {
+    'any CHC system': {'transition-system', 'transition-system-chain', 'linear', 'nonlinear'},
+    'only linear CHC systems': {'transition-system', 'transition-system-chain', 'linear'},
+    'only transition systems': {'transition-system'},
+}
+
+# Engines for transition systems that also solve chains of transition systems; the others answer unknown on them
+CHAIN_ENGINES = {'tpa', 'split-tpa'}
+
+
+def engines(golem):
+    """Engines listed in the help message of Golem together with the shapes of systems they support"""
+    usage = subprocess.run([golem, '--help'], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True).stdout
+    pattern = re.compile(r'^\s+([\w-]+) - .*\(({})\)\s*$'.format('|'.join(map(re.escape, SUPPORTED_SHAPES))))
+    result = {}
+    for line in usage.splitlines():
+        match = pattern.match(line)
+        if match:
+            shapes = set(SUPPORTED_SHAPES[match.group(2)])
+            if match.group(1) in CHAIN_ENGINES:
+                shapes.add('transition-system-chain')
+            result[match.group(1)] = shapes
+    if not result:
+        raise RuntimeError('Could not read the list of engines from the help message of ' + golem)
+    return result
+
+
+def run(golem, engine, logic, path, timeout):
+    """Runs Golem on a single benchmark; returns the answer, wall time in seconds and peak memory in KiB"""
+    start = time.monotonic()
+    process = subprocess.Popen([golem, '-l', logic, '-e', engine, path], stdout=subprocess.PIPE,
+                               stderr=subprocess.DEVNULL, text=True)
+    answer = None
+    while True:
+        pid, status, usage = os.wait4(process.pid, os.WNOHANG)
+        if pid != 0:
+            break
+        if time.monotonic() - start > timeout:
+            process.send_signal(signal.SIGKILL)
+            pid, status, usage = os.wait4(process.pid, 0)
+            answer = 'timeout'
+            break
+        time.sleep(0.01)
+    elapsed = time.monotonic() - start
+    output = process.stdout.read()
+    process.stdout.close()
+    if answer is None:
+        lines = output.split()
+        answer = lines[0] if lines and lines[0] in ('sat', 'unsat', 'unknown') else 'error'
+    # ru_maxrss is reported in KiB on Linux
+    return answer, round(elapsed, 3), usage.ru_maxrss
+
+
+def compare(results, baseline, slowdown, threshold):
+    """Differences against the baseline: changed answers and slowdowns of runs taking at least threshold seconds"""
+    previous = {(entry['file'], entry['engine']): entry for entry in baseline}
+    problems = []
+    for entry in results:
+        old = previous.get((entry['file'], entry['engine']))
+        if old is None:
+            continue
+        name = '{} ({})'.format(entry['file'], entry['engine'])
+        if entry['answer'] != old['answer']:
+            problems.append('{}: answer {} (baseline {})'.format(name, entry['answer'], old['answer']))
+        elif entry['time'] >= threshold and entry['time'] > slowdown * old['time']:
+            problems.append('{}: time {}s (baseline {}s)'.format(name, entry['time'], old['time']))
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run Golem engines on generated CHC benchmarks')
+    parser.add_argument('--golem', required=True, help='path to the golem executable')
+    parser.add_argument('--benchmarks', required=True, help='directory produced by generator.py')
+    parser.add_argument('--output', required=True, help='JSON file with the results')
+    parser.add_argument('--engines', nargs='+', help='run only these engines')
+    parser.add_argument('--timeout', type=float, default=60, help='timeout per run in seconds')
+    parser.add_argument('--baseline', help='JSON file with the results of a previous run')
+    parser.add_argument('--slowdown', type=float, default=1.5, help='reported slowdown factor against the baseline')
+    parser.add_argument('--min-time', type=float, default=0.1, help='ignore slowdowns of runs faster than this')
+    args = parser.parse_args()
+
+    available = engines(args.golem)
+    selected = args.engines if args.engines else sorted(available)
+    with open(os.path.join(args.benchmarks, 'index.json')) as index_file:
+        index = json.load(index_file)
+
+    results = []
+    wrong = []
+    for benchmark in index:
+        for engine in selected:
+            if benchmark['shape'] not in available.get(engine, set()):
+                continue
+            path = os.path.join(args.benchmarks, benchmark['file'])
+            answer, elapsed, memory = run(args.golem, engine, benchmark['logic'], path, args.timeout)
+            entry = dict(benchmark, engine=engine, answer=answer, time=elapsed, memory=memory)
+            results.append(entry)
+            print('{} {}: {} {}s {}KiB'.format(benchmark['file'], engine, answer, elapsed, memory), flush=True)
+            if answer in ('sat', 'unsat') and answer != benchmark['expected']:
+                wrong.append('{} ({}): answer {}, expected {}'.format(benchmark['file'], engine, answer,
+                                                                       benchmark['expected']))
+
+    with open(args.output, 'w') as out:
+        json.dump(results, out, indent=2)
+
+    problems = list(wrong)
+    if args.baseline:
+        with open(args.baseline) as baseline_file:
+            problems += compare(results, json.load(baseline_file), args.slowdown, args.min_time)
+    for problem in problems:
+        print(problem, file=sys.stderr)
+    sys.exit(1 if problems else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -7,6 +7,7 @@
 #include <engine/Bmc.h>
 #include <engine/Kind.h>
 #include <engine/Lawi.h>
+#include <engine/PDR.h>
 #include <engine/Spacer.h>
 #include <engine/TPA.h>
 #include <engine/IMC.h>
@@ -15,11 +16,23 @@
 #include "graph/ChcGraphBuilder.h"
 #include "graph/GraphTransformations.h"
 #include "Validator.h"
+#include "MemoryAccounting.h"
 #include "Normalizer.h"
+#include "Progress.h"
+#include "QueryDump.h"
+#include "Tracing.h"
+#include "transformers/GraphReverser.h"
 #include "transformers/RemoveUnreachableNodes.h"
 #include "transformers/SimpleChainSummarizer.h"
 #include "transformers/TransformationPipeline.h"
 
+#include <csignal>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
 using namespace osmttokens;
 
 namespace {
@@ -41,6 +54,107 @@ bool addLetFrame(const vec<char *> & names, vec<PTRef> const& args, Logic & logi
     }
     return true;
 }
+
+/*
+ * Runs `solve` in the forward and in the backward direction concurrently, in two child processes (the term store is
+ * not thread-safe), and forwards the standard output of the first run that decides the system.
+ */
+void raceDirections(std::function<void(bool)> const & solve, int verbosity) {
+    struct Run {
+        bool backward;
+        FILE * output;
+        pid_t pid;
+        bool finished;
+        bool succeeded;
+    };
+    std::cout << std::flush;
+    std::vector<Run> runs;
+    for (bool backward : {false, true}) {
+        FILE * output = std::tmpfile();
+        pid_t pid = output ? fork() : -1;
+        if (pid < 0) {
+            for (auto const & run : runs) { kill(run.pid, SIGKILL); waitpid(run.pid, nullptr, 0); }
+            throw std::logic_error("Could not start the solver processes for both directions");
+        }
+        if (pid == 0) {
+            dup2(fileno(output), STDOUT_FILENO);
+            char const * direction = backward ? "backward" : "forward";
+            int status = 0;
+            try {
+                // Each child dumps queries and writes its trace separately, the parent's files would be overwritten
+                QueryDump::useSubdirectory(direction);
+                Tracing::useFileSuffix(direction);
+                solve(backward);
+            } catch (std::exception const & e) {
+                std::cerr << "; " << direction << " direction failed: " << e.what() << std::endl;
+                status = 1;
+            }
+            try {
+                Tracing::flush();
+            } catch (std::exception const & e) {
+                std::cerr << "; " << e.what() << std::endl;
+            }
+            // _exit skips the exit handlers, deliver the last progress report of this direction here
+            if (Progress::isEnabled()) { Progress::disable(); }
+            std::cout << std::flush;
+            std::fflush(stdout);
+            _exit(status);
+        }
+        runs.push_back(Run{backward, output, pid, false, false});
+    }
+    auto contentOf = [](Run const & run) {
+        std::rewind(run.output);
+        std::string content;
+        char buffer[4096];
+        std::size_t read;
+        while ((read = std::fread(buffer, 1, sizeof(buffer), run.output)) > 0) {
+            content.append(buffer, read);
+        }
+        return content;
+    };
+    auto isDecided = [](std::string const & content) {
+        std::istringstream lines(content);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line == "sat" or line == "unsat") { return true; }
+            if (line == "unknown") { return false; }
+        }
+        return false;
+    };
+    Run const * winner = nullptr;
+    std::size_t running = runs.size();
+    while (running > 0 and not winner) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) { break; }
+        auto it = std::find_if(runs.begin(), runs.end(), [pid](Run const & run) { return run.pid == pid; });
+        if (it == runs.end()) { continue; }
+        --running;
+        it->finished = true;
+        it->succeeded = WIFEXITED(status) and WEXITSTATUS(status) == 0;
+        if (it->succeeded and isDecided(contentOf(*it))) { winner = &*it; }
+    }
+    for (auto & run : runs) {
+        if (not run.finished) {
+            kill(run.pid, SIGKILL);
+            waitpid(run.pid, nullptr, 0);
+        }
+    }
+    if (not winner) {
+        // Neither direction decided the system; report the forward run if it finished normally
+        auto forward = std::find_if(runs.begin(), runs.end(), [](Run const & run) { return not run.backward and run.succeeded; });
+        if (forward == runs.end()) {
+            for (auto const & run : runs) { std::fclose(run.output); }
+            throw std::logic_error("Solving failed in both directions");
+        }
+        winner = &*forward;
+    }
+    std::cout << contentOf(*winner);
+    if (verbosity > 0) {
+        std::cout << "; GOLEM: Result obtained in the " << (winner->backward ? "backward" : "forward") << " direction" << std::endl;
+    }
+    for (auto const & run : runs) { std::fclose(run.output); }
+}
 }
 
 std::unique_ptr<ChcSystem> ChcInterpreter::interpretSystemAst(Logic & logic, const ASTNode * root) {
@@ -310,25 +424,70 @@ PTRef ChcInterpreterContext::parseTerm(const ASTNode & termNode) {
 void ChcInterpreterContext::interpretCheckSat() {
     bool validateWitness = opts.hasOption(Options::VALIDATE_RESULT);
     assert(not validateWitness || opts.getOption(Options::VALIDATE_RESULT) == std::string("true"));
-    bool printWitness = opts.hasOption(Options::PRINT_WITNESS);
-    assert(not printWitness || opts.getOption(Options::PRINT_WITNESS) == std::string("true"));
+    int verbosity = opts.hasOption(Options::VERBOSE) ? std::stoi(opts.getOption(Options::VERBOSE)) : 0;
+    MemoryAccounting memory(logic, "GOLEM");
+    auto memoryCheckpoint = [&](std::string const & phase) {
+        if (verbosity > 0) { memory.printCheckpoint(std::cout, phase); }
+    };
 
 //    ChcPrinter(logic).print(*system, std::cout);
-    auto normalizedSystem = Normalizer(logic).normalize(*system);
-    auto hypergraph = ChcGraphBuilder(logic).buildGraph(normalizedSystem);
+    auto normalizedSystem = [&]() {
+        GOLEM_TRACE_SCOPE("normalize");
+        return Normalizer(logic).normalize(*system);
+    }();
+    auto hypergraph = [&]() {
+        GOLEM_TRACE_SCOPE("build graph");
+        return ChcGraphBuilder(logic).buildGraph(normalizedSystem);
+    }();
+    memoryCheckpoint("normalization and graph construction");
     std::unique_ptr<ChcDirectedHyperGraph> originalGraph {nullptr};
     if (validateWitness) { // Store copy of the original graph for validating purposes
         originalGraph = std::make_unique<ChcDirectedHyperGraph>(*hypergraph);
     }
 
+    std::string direction = opts.hasOption(Options::DIRECTION) ? opts.getOption(Options::DIRECTION) : "forward";
+    if (direction != "forward" and direction != "backward" and direction != "both") {
+        throw std::invalid_argument("Unknown direction specified");
+    }
+    if (direction == "both") {
+        raceDirections([&](bool backward) {
+            solve(std::move(hypergraph), originalGraph.get(), backward, memory, verbosity);
+        }, verbosity);
+    } else {
+        solve(std::move(hypergraph), originalGraph.get(), direction == "backward", memory, verbosity);
+    }
+}
+
+void ChcInterpreterContext::solve(std::unique_ptr<ChcDirectedHyperGraph> hypergraph, ChcDirectedHyperGraph const * originalGraph, bool backward,
+                                  MemoryAccounting & memory, int verbosity) {
+    bool validateWitness = originalGraph != nullptr;
+    bool printWitness = opts.hasOption(Options::PRINT_WITNESS);
+    assert(not printWitness || opts.getOption(Options::PRINT_WITNESS) == std::string("true"));
+    auto memoryCheckpoint = [&](std::string const & phase) {
+        if (verbosity > 0) { memory.printCheckpoint(std::cout, phase); }
+    };
+
     TransformationPipeline::pipeline_t transformations;
     transformations.push_back(std::make_unique<SimpleChainSummarizer>(logic));
     transformations.push_back(std::make_unique<RemoveUnreachableNodes>());
-    auto [newGraph, translator] = TransformationPipeline(std::move(transformations)).transform(std::move(hypergraph));
+    if (backward) {
+        transformations.push_back(std::make_unique<GraphReverser>());
+        // The exit of the reversed graph is the original entry, prune what cannot reach it
+        transformations.push_back(std::make_unique<RemoveUnreachableNodes>());
+    }
+    auto [newGraph, translator] = [&]() {
+        GOLEM_TRACE_SCOPE("transformation pipeline");
+        return TransformationPipeline(std::move(transformations)).transform(std::move(hypergraph));
+    }();
     hypergraph = std::move(newGraph);
+    memoryCheckpoint("transformations");
 
     auto engine = getEngine();
-    auto result = engine->solve(*hypergraph);
+    auto result = [&]() {
+        GOLEM_TRACE_SCOPE("engine");
+        return engine->solve(*hypergraph);
+    }();
+    memoryCheckpoint("engine");
     switch (result.getAnswer()) {
         case VerificationAnswer::SAFE: {
             std::cout << "sat" << std::endl;
@@ -343,13 +502,20 @@ void ChcInterpreterContext::interpretCheckSat() {
             return;
     }
     if (validateWitness || printWitness) {
-        result = translator->translate(std::move(result));
+        {
+            GOLEM_TRACE_SCOPE("witness back-translation");
+            result = translator->translate(std::move(result));
+        }
+        memoryCheckpoint("witness back-translation");
         if (printWitness) {
             result.printWitness(std::cout, logic);
         }
         if (validateWitness) {
-            assert(originalGraph);
-            auto validationResult = Validator(logic).validate(*originalGraph, result);
+            auto validationResult = [&]() {
+                GOLEM_TRACE_SCOPE("validation");
+                return Validator(logic).validate(*originalGraph, result);
+            }();
+            memoryCheckpoint("validation");
             switch (validationResult) {
                 case Validator::Result::VALIDATED: {
                     std::cout << "Internal witness validation successful!" << std::endl;
@@ -440,8 +606,10 @@ std::unique_ptr<Engine> ChcInterpreterContext::getEngine() const {
         return std::unique_ptr<Engine>(new Spacer(logic, opts));
     } else if (engineStr == "kind") {
         return std::unique_ptr<Engine>(new Kind(logic, opts));
-    } else if (engineStr == "imc") {
+    } else if (engineStr == IMC::ORIGINAL or engineStr == IMC::INTERPOLATION_SEQUENCES) {
         return std::unique_ptr<Engine>(new IMC(logic, opts));
+    } else if (engineStr == "pdr") {
+        return std::unique_ptr<Engine>(new PDR(logic, opts));
     } else {
         throw std::invalid_argument("Unknown engine specified");
     }
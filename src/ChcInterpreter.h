@@ -8,6 +8,7 @@
 #define OPENSMT_CHCINTERPRETER_H
 
 #include "ChcSystem.h"
+#include "MemoryAccounting.h"
 #include "Options.h"
 
 #include <engine/Engine.h> // TODO: remove this and create an engine factory
@@ -98,6 +99,11 @@ private:
 
     void interpretCheckSat();
 
+    // Runs the transformations, the engine and the witness processing on the graph, reversed if `backward` is set.
+    // The witness is validated against `originalGraph` if it is given.
+    void solve(std::unique_ptr<ChcDirectedHyperGraph> graph, ChcDirectedHyperGraph const * originalGraph, bool backward,
+               MemoryAccounting & memory, int verbosity);
+
     void reportError(std::string msg);
 
     SRef sortFromASTNode(ASTNode const & node) const;
@@ -5,6 +5,7 @@
 #ifndef OPENSMT_CHCSYSTEM_H
 #define OPENSMT_CHCSYSTEM_H
 
+#include "SmallVector.h"
 #include "osmt_terms.h"
 
 #include <vector>
@@ -34,18 +35,16 @@ inline bool operator==(ChcHead const & h1, ChcHead const & h2) {
 }
 inline bool operator!=(ChcHead const & h1, ChcHead const & h2) { return not(h1 == h2); }
 
+// Bodies with up to two predicates (all linear clauses and most nonlinear ones) are stored without heap allocation
+using UninterpretedPredicates = SmallVector<UninterpretedPredicate, 2>;
+
 struct ChcBody {
     InterpretedFla interpretedPart;
-    std::vector<UninterpretedPredicate> uninterpretedPart;
+    UninterpretedPredicates uninterpretedPart;
 };
 
 inline bool operator==(ChcBody const & b1, ChcBody const & b2) {
-    if (b1.interpretedPart != b2.interpretedPart) { return false; }
-    if (b1.uninterpretedPart.size() != b2.uninterpretedPart.size()) { return false; }
-    for (std::size_t i = 0; i < b1.uninterpretedPart.size(); ++i) {
-        if (b1.uninterpretedPart[i] != b2.uninterpretedPart[i]) { return false; }
-    }
-    return true;
+    return b1.interpretedPart == b2.interpretedPart and b1.uninterpretedPart == b2.uninterpretedPart;
 }
 inline bool operator!=(ChcBody const & b1, ChcBody const & b2) { return not(b1 == b2); }
 
@@ -97,7 +96,7 @@ public:
     }
     template<typename TIt>
     static ChcBody constructBody(PTRef interpreted, TIt uninterpretedBegin, TIt uninterpretedEnd) {
-        std::vector<UninterpretedPredicate> uninterpretedPart;
+        UninterpretedPredicates uninterpretedPart;
         std::transform(uninterpretedBegin, uninterpretedEnd, std::back_inserter(uninterpretedPart), [](PTRef ref) {
             return UninterpretedPredicate{.predicate = ref};
         });
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "FreeVariables.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+VariableSet::VariableSet(std::vector<PTRef> vars_) : vars(std::move(vars_)) {
+    std::sort(vars.begin(), vars.end(), less);
+    vars.erase(std::unique(vars.begin(), vars.end()), vars.end());
+}
+
+VariableSet::VariableSet(vec<PTRef> const & vars_) : VariableSet(std::vector<PTRef>(vars_.begin(), vars_.end())) {}
+
+bool VariableSet::isSubsetOf(VariableSet const & other) const {
+    return std::includes(other.vars.begin(), other.vars.end(), vars.begin(), vars.end(), less);
+}
+
+VariableSet VariableSet::unite(VariableSet const & other) const {
+    VariableSet result;
+    std::set_union(vars.begin(), vars.end(), other.vars.begin(), other.vars.end(), std::back_inserter(result.vars), less);
+    return result;
+}
+
+VariableSet VariableSet::intersect(VariableSet const & other) const {
+    VariableSet result;
+    std::set_intersection(vars.begin(), vars.end(), other.vars.begin(), other.vars.end(), std::back_inserter(result.vars), less);
+    return result;
+}
+
+VariableSet VariableSet::minus(VariableSet const & other) const {
+    VariableSet result;
+    std::set_difference(vars.begin(), vars.end(), other.vars.begin(), other.vars.end(), std::back_inserter(result.vars), less);
+    return result;
+}
+
+vec<PTRef> VariableSet::toVec() const {
+    vec<PTRef> result;
+    result.capacity(static_cast<int>(vars.size()));
+    for (PTRef var : vars) {
+        result.push(var);
+    }
+    return result;
+}
+
+namespace {
+struct Registry {
+    std::unordered_map<Logic const *, std::unique_ptr<FreeVariables>> caches;
+    std::mutex mutex;
+};
+
+Registry & registry() {
+    static Registry instance;
+    return instance;
+}
+}
+
+FreeVariables::Registration::Registration(Logic & logic) : logic(logic) {
+    auto & reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.caches.insert({&logic, std::make_unique<FreeVariables>(logic)});
+}
+
+FreeVariables::Registration::~Registration() {
+    auto & reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.caches.erase(&logic);
+}
+
+VariableSet FreeVariables::of(Logic & logic, PTRef term) {
+    FreeVariables * cache = nullptr;
+    {
+        auto & reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto it = reg.caches.find(&logic);
+        if (it != reg.caches.end()) { cache = it->second.get(); }
+    }
+    if (not cache) {
+        return VariableSet(::variables(logic, term));
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    return cache->compute(term);
+}
+
+VariableSet const & FreeVariables::compute(PTRef root) {
+    auto cached = cache.find(root);
+    if (cached != cache.end()) { return cached->second; }
+    // Post-order traversal; a term is processed when all its children have their sets
+    std::vector<std::pair<PTRef, bool>> stack{{root, false}};
+    while (not stack.empty()) {
+        auto [term, expanded] = stack.back();
+        if (cache.count(term) > 0) {
+            stack.pop_back();
+            continue;
+        }
+        if (logic.isVar(term)) {
+            cache.insert({term, VariableSet(std::vector<PTRef>{term})});
+            stack.pop_back();
+            continue;
+        }
+        Pterm const & pterm = logic.getPterm(term);
+        if (not expanded) {
+            stack.back().second = true;
+            for (PTRef child : pterm) {
+                if (cache.count(child) == 0) { stack.push_back({child, false}); }
+            }
+            continue;
+        }
+        stack.pop_back();
+        std::vector<PTRef> vars;
+        for (PTRef child : pterm) {
+            auto const & childVars = cache.at(child);
+            vars.insert(vars.end(), childVars.begin(), childVars.end());
+        }
+        cache.insert({term, VariableSet(std::move(vars))});
+    }
+    return cache.at(root);
+}
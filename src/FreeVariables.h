@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_FREEVARIABLES_H
+#define GOLEM_FREEVARIABLES_H
+
+#include "osmt_terms.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Set of variables stored as a vector sorted by the term index; set operations are linear merges.
+ */
+class VariableSet {
+    std::vector<PTRef> vars;
+
+    static bool less(PTRef first, PTRef second) { return first.x < second.x; }
+
+public:
+    VariableSet() = default;
+    explicit VariableSet(std::vector<PTRef> vars);
+    explicit VariableSet(vec<PTRef> const & vars);
+
+    auto begin() const { return vars.begin(); }
+    auto end() const { return vars.end(); }
+    std::size_t size() const { return vars.size(); }
+    bool empty() const { return vars.empty(); }
+
+    bool contains(PTRef var) const { return std::binary_search(vars.begin(), vars.end(), var, less); }
+
+    bool isSubsetOf(VariableSet const & other) const;
+
+    VariableSet unite(VariableSet const & other) const;
+
+    VariableSet intersect(VariableSet const & other) const;
+
+    VariableSet minus(VariableSet const & other) const;
+
+    vec<PTRef> toVec() const;
+};
+
+/*
+ * Cache of the free variables of terms of a single Logic.
+ *
+ * The sets are computed bottom-up, once for every subterm, and shared by all later queries.
+ * Since terms are never removed from a Logic, the cache never needs to be invalidated, but it must not outlive
+ * its Logic. A cache is therefore used only while a Registration for the Logic exists; without it, queries
+ * traverse the term every time. Queries are thread-safe.
+ */
+class FreeVariables {
+    Logic & logic;
+    std::unordered_map<PTRef, VariableSet, PTRefHash> cache;
+    std::mutex mutex;
+
+    VariableSet const & compute(PTRef term);
+
+public:
+    explicit FreeVariables(Logic & logic) : logic(logic) {}
+
+    class Registration {
+        Logic const & logic;
+    public:
+        explicit Registration(Logic & logic);
+        Registration(Registration const &) = delete;
+        Registration & operator=(Registration const &) = delete;
+        ~Registration();
+    };
+
+    // Free variables of the term, from the cache registered for the logic if there is one
+    static VariableSet of(Logic & logic, PTRef term);
+};
+
+#endif //GOLEM_FREEVARIABLES_H
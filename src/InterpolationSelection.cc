@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "InterpolationSelection.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <unordered_set>
+
+InterpolationAlgorithmSelector::InterpolationAlgorithmSelector(Options const & options) {
+    std::string value = options.hasOption(Options::LRA_ITP_ALG) ? options.getOption(Options::LRA_ITP_ALG) : "0";
+    if (value == "adaptive" or value == "smallest") {
+        mode = value == "adaptive" ? Mode::ADAPTIVE : Mode::SMALLEST;
+        arms = {
+            Arm{itp_lra_alg_strong, "strong"},
+            Arm{itp_lra_alg_weak, "weak"},
+            Arm{itp_lra_alg_factor, "factor"},
+            Arm{itp_lra_alg_decomposing_strong, "decomposing strong"},
+            Arm{itp_lra_alg_decomposing_weak, "decomposing weak"}
+        };
+    } else {
+        mode = Mode::FIXED;
+        arms = {Arm{ItpAlgorithm{std::atoi(value.c_str())}, "fixed"}};
+    }
+}
+
+std::size_t InterpolationAlgorithmSelector::select() const {
+    if (mode != Mode::ADAPTIVE) { return 0; }
+    std::size_t best = 0;
+    double bestBound = -1;
+    for (std::size_t i = 0; i < arms.size(); ++i) {
+        if (arms[i].uses == 0) { return i; }
+        double average = arms[i].totalReward / static_cast<double>(arms[i].uses);
+        double bound = average + std::sqrt(2 * std::log(static_cast<double>(totalUses)) / static_cast<double>(arms[i].uses));
+        if (bound > bestBound) {
+            bestBound = bound;
+            best = i;
+        }
+    }
+    return best;
+}
+
+void InterpolationAlgorithmSelector::reward(std::size_t arm, double value) {
+    assert(arm < arms.size());
+    ++arms[arm].uses;
+    arms[arm].totalReward += value;
+    ++totalUses;
+}
+
+void InterpolationAlgorithmSelector::printStatistics(std::ostream & out, std::string const & engine) const {
+    if (mode == Mode::FIXED) { return; }
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << "; " << engine << ": Interpolation algorithms (" << (mode == Mode::ADAPTIVE ? "adaptive" : "smallest") << ")\n";
+    for (auto const & arm : arms) {
+        double average = arm.uses == 0 ? 0 : arm.totalReward / static_cast<double>(arm.uses);
+        out << "; " << engine << ":   " << std::left << std::setw(20) << arm.name << std::right
+            << " used " << std::setw(6) << arm.uses << " times, average reward " << std::fixed << std::setprecision(3)
+            << average << '\n';
+    }
+    out << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+std::size_t InterpolationAlgorithmSelector::dagSize(Logic & logic, PTRef term) {
+    std::unordered_set<PTRef, PTRefHash> seen;
+    std::vector<PTRef> queue{term};
+    while (not queue.empty()) {
+        PTRef current = queue.back();
+        queue.pop_back();
+        if (not seen.insert(current).second) { continue; }
+        Pterm const & pterm = logic.getPterm(current);
+        for (int i = 0; i < pterm.size(); ++i) {
+            queue.push_back(pterm[i]);
+        }
+    }
+    return seen.size();
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_INTERPOLATIONSELECTION_H
+#define GOLEM_INTERPOLATIONSELECTION_H
+
+#include "Options.h"
+#include "osmt_solver.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Choice of the LRA interpolation algorithm at runtime.
+ *
+ * In the adaptive mode, the choice is a multi-armed bandit (UCB1): every algorithm is tried once, then the one with
+ * the best upper confidence bound on its average reward is chosen. The engine decides what a reward is, e.g., whether
+ * the interpolants led to a covering. In the smallest mode, the engine computes the interpolants with every algorithm
+ * from the same proof and keeps the smallest ones; the selector only records which algorithm won.
+ * The mode is given by the value of --lra-itp-algorithm: a number of an OpenSMT algorithm, "adaptive", or "smallest".
+ */
+class InterpolationAlgorithmSelector {
+public:
+    enum class Mode { FIXED, ADAPTIVE, SMALLEST };
+
+    explicit InterpolationAlgorithmSelector(Options const & options);
+
+    Mode getMode() const { return mode; }
+
+    std::size_t armCount() const { return arms.size(); }
+
+    ItpAlgorithm algorithm(std::size_t arm) const { return arms[arm].algorithm; }
+
+    // Arm to use for the next interpolation query
+    std::size_t select() const;
+
+    // Reward in [0,1] for the interpolants computed with the given arm
+    void reward(std::size_t arm, double value);
+
+    void printStatistics(std::ostream & out, std::string const & engine) const;
+
+    // Number of distinct subterms, a measure of the size of an interpolant
+    static std::size_t dagSize(Logic & logic, PTRef term);
+
+private:
+    struct Arm {
+        ItpAlgorithm algorithm;
+        char const * name;
+        std::size_t uses = 0;
+        double totalReward = 0;
+    };
+
+    Mode mode;
+    std::vector<Arm> arms;
+    std::size_t totalUses = 0;
+};
+
+#endif //GOLEM_INTERPOLATIONSELECTION_H
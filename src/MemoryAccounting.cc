@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "MemoryAccounting.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+std::size_t residentBytes() {
+    // Current resident set size on Linux; peak resident set size elsewhere
+    std::ifstream statm("/proc/self/statm");
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+double mebibytes(std::size_t bytes) {
+    return static_cast<double>(bytes) / (1024 * 1024);
+}
+
+// Signed difference, the resident memory may shrink
+long long growth(std::size_t now, std::size_t before) {
+    return static_cast<long long>(now) - static_cast<long long>(before);
+}
+}
+
+MemoryAccounting::Scope::Scope(MemoryAccounting & accounting, std::string component)
+    : accounting(accounting), component(std::move(component)),
+      termsAtStart(static_cast<std::size_t>(accounting.logic.getNumberOfTerms())) {}
+
+MemoryAccounting::Scope::~Scope() {
+    accounting.components[component] += static_cast<std::size_t>(accounting.logic.getNumberOfTerms()) - termsAtStart;
+}
+
+MemoryAccounting::MemoryAccounting(Logic & logic, std::string name)
+    : logic(logic), name(std::move(name)), last(current(logic)) {}
+
+MemoryAccounting::Usage MemoryAccounting::current(Logic & logic) {
+    return Usage{static_cast<std::size_t>(logic.getNumberOfTerms()), residentBytes()};
+}
+
+MemoryAccounting::Usage MemoryAccounting::checkpoint(std::string const & phase) {
+    Usage now = current(logic);
+    Usage grown{now.terms - last.terms, now.residentBytes > last.residentBytes ? now.residentBytes - last.residentBytes : 0};
+    auto & total = phases[phase];
+    total.terms += grown.terms;
+    total.residentBytes += grown.residentBytes;
+    last = now;
+    return grown;
+}
+
+void MemoryAccounting::printCheckpoint(std::ostream & out, std::string const & phase) {
+    Usage before = last;
+    checkpoint(phase);
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << "; " << name << " MEMORY: " << phase << ": +" << last.terms - before.terms << " terms (" << last.terms
+        << " total), " << std::showpos << std::fixed << std::setprecision(1)
+        << static_cast<double>(growth(last.residentBytes, before.residentBytes)) / (1024 * 1024)
+        << std::noshowpos << " MiB resident (" << mebibytes(last.residentBytes) << " MiB total)" << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void MemoryAccounting::printSummary(std::ostream & out) const {
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    for (auto const & [phase, usage] : phases) {
+        out << "; " << name << " MEMORY: phase " << phase << ": " << usage.terms << " terms, "
+            << mebibytes(usage.residentBytes) << " MiB resident\n";
+    }
+    for (auto const & [component, terms] : components) {
+        out << "; " << name << " MEMORY: component " << component << ": " << terms << " terms\n";
+    }
+    out << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_MEMORYACCOUNTING_H
+#define GOLEM_MEMORYACCOUNTING_H
+
+#include "osmt_terms.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+
+/*
+ * Accounting of the growth of the term store and of the resident memory of the process.
+ *
+ * The term store of a Logic only grows, so the number of terms created in a phase is the difference of the sizes
+ * of the store at its end and at its start. Checkpoints attribute the growth since the previous checkpoint to
+ * a phase; scopes attribute the terms created inside them to a component (scopes of different components may nest,
+ * in which case the terms are counted in both). Resident memory is sampled only at checkpoints.
+ */
+class MemoryAccounting {
+public:
+    struct Usage {
+        std::size_t terms = 0;
+        std::size_t residentBytes = 0;
+    };
+
+    class Scope {
+        MemoryAccounting & accounting;
+        std::string component;
+        std::size_t termsAtStart;
+    public:
+        Scope(MemoryAccounting & accounting, std::string component);
+        Scope(Scope const &) = delete;
+        Scope & operator=(Scope const &) = delete;
+        ~Scope();
+    };
+
+    MemoryAccounting(Logic & logic, std::string name);
+
+    static Usage current(Logic & logic);
+
+    // Attributes the growth since the previous checkpoint to the given phase and returns it
+    Usage checkpoint(std::string const & phase);
+
+    // Prints the growth since the previous checkpoint as a single verbose line
+    void printCheckpoint(std::ostream & out, std::string const & phase);
+
+    // Prints the totals of all phases and components
+    void printSummary(std::ostream & out) const;
+
+private:
+    Logic & logic;
+    std::string name;
+    Usage last;
+    std::map<std::string, Usage> phases;
+    std::map<std::string, std::size_t> components;
+};
+
+#endif //GOLEM_MEMORYACCOUNTING_H
@@ -422,13 +422,7 @@ void checkImplicant(ModelBasedProjection::implicant_t const & implicant, Logic &
 }
 
 PTRef ModelBasedProjection::keepOnly(PTRef fla, const vec<PTRef> & varsToKeep, Model & model) {
-    auto allVars = TermUtils(logic).getVars(fla);
-    vec<PTRef> toEliminate;
-    for (PTRef var : allVars) {
-        if (std::find(varsToKeep.begin(), varsToKeep.end(), var) == varsToKeep.end()) {
-            toEliminate.push(var);
-        }
-    }
+    vec<PTRef> toEliminate = FreeVariables::of(logic, fla).minus(VariableSet(varsToKeep)).toVec();
     return project(fla, toEliminate, model);
 }
 
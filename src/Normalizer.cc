@@ -104,7 +104,7 @@ ChcHead Normalizer::normalize(ChcHead const& head) {
 
 ChcBody Normalizer::normalize(const ChcBody & body) {
     // uninterpreted part
-    std::vector<UninterpretedPredicate> newUninterpretedPart;
+    UninterpretedPredicates newUninterpretedPart;
     auto const& uninterpreted = body.uninterpretedPart;
     auto proxy = canonicalPredicateRepresentation.createCountingProxy();
     for (auto const& predicateWrapper : uninterpreted) {
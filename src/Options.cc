@@ -22,6 +22,14 @@ const std::string Options::LRA_ITP_ALG = "lra-itp-algorithm";
 const std::string Options::FORCED_COVERING = "forced-covering";
 const std::string Options::VERBOSE = "verbose";
 const std::string Options::TPA_USE_QE = "tpa.use-qe";
+const std::string Options::LAWI_BLOCK_ENCODING = "lawi.block-encoding";
+const std::string Options::KIND_SIMPLE_PATH = "kind.simple-path";
+const std::string Options::KIND_AUX_INVARIANTS = "kind.aux-invariants";
+const std::string Options::DUMP_QUERIES = "dump-queries";
+const std::string Options::TRACE = "trace";
+const std::string Options::PROGRESS = "progress";
+const std::string Options::DIRECTION = "direction";
+const std::string Options::BMC_SCHEDULE = "bmc.schedule";
 
 namespace{
 
@@ -32,15 +40,27 @@ void printUsage() {
         "-h,--help                  Print this help message\n"
         "-l,--logic <name>          SMT-LIB logic to use (required); possible values: QF_LRA, QF_LIA\n"
         "-e,--engine <name>         Select engine to use; supported engines:\n"
-        "                               bmc - Bounded Model Checking (only transition systems)\n"
+        "                               bmc - Bounded Model Checking (any CHC system)\n"
         "                               imc - McMillan's original Interpolation-based model checking (only transition systems)\n"
+        "                               ismc - Interpolation-sequence based model checking (only transition systems)\n"
         "                               kind - basic k-induction algorithm (only transition systems)\n"
         "                               lawi - Lazy Abstraction with Interpolants (only linear CHC systems)\n"
+        "                               pdr - IC3/Property Directed Reachability (only transition systems)\n"
         "                               spacer - custom implementation of Spacer (any CHC system)\n"
         "                               split-tpa - Split Transition Power Abstraction (only transition systems)\n"
         "                               tpa - Transition Power Abstraction (only transition systems)\n"
+        "--direction <dir>          Direction of the analysis of linear systems: forward (default), backward, or both\n"
+        "                               (both directions run concurrently in separate processes, first answer wins)\n"
+        "--lra-itp-algorithm <alg>  LRA interpolation algorithm used by lawi: number of an OpenSMT algorithm (default 0),\n"
+        "                               adaptive (learn the best algorithm during the run), or smallest (pick the smallest\n"
+        "                               interpolants of all algorithms for every query)\n"
+        "--bmc.schedule <schedule>  Bounds checked by bmc on transition systems: linear (every bound, default), a number k\n"
+        "                               (blocks of k bounds checked at once), or geometric (blocks doubling in size)\n"
         "--validate                 Internally validate computed solution\n"
         "--print-witness            Print computed solution\n"
+        "--dump-queries <dir>       Write every SMT query to <dir> (for replaying with golem-replay)\n"
+        "--trace <file>             Write a timeline of the run in Chrome trace-event format to <file>\n"
+        "--progress <seconds>       Report partial results of the engine as JSON lines on stderr, at most once per <seconds>\n"
         "-v                         Increase verbosity (can be applied multiple times)\n"
         "-i,--input <file>          Input file (option not required)\n"
         ;
@@ -62,6 +82,14 @@ Options CommandLineParser::parse(int argc, char ** argv) {
     int forcedCovering = 0;
     int verbose = 0;
     int tpaUseQE = 0;
+    int lawiBlockEncoding = 0;
+    int kindSimplePath = 0;
+    int kindAuxInvariants = 0;
+    int dumpQueries = 0;
+    int trace = 0;
+    int progress = 0;
+    int direction = 0;
+    int bmcSchedule = 0;
 
     struct option long_options[] =
         {
@@ -77,6 +105,14 @@ Options CommandLineParser::parse(int argc, char ** argv) {
             {Options::FORCED_COVERING.c_str(), optional_argument, &forcedCovering, 1},
             {Options::VERBOSE.c_str(), optional_argument, &verbose, 1},
             {Options::TPA_USE_QE.c_str(), optional_argument, &tpaUseQE, 1},
+            {Options::LAWI_BLOCK_ENCODING.c_str(), optional_argument, &lawiBlockEncoding, 1},
+            {Options::KIND_SIMPLE_PATH.c_str(), optional_argument, &kindSimplePath, 1},
+            {Options::KIND_AUX_INVARIANTS.c_str(), optional_argument, &kindAuxInvariants, 1},
+            {Options::DUMP_QUERIES.c_str(), required_argument, &dumpQueries, 1},
+            {Options::TRACE.c_str(), required_argument, &trace, 1},
+            {Options::PROGRESS.c_str(), required_argument, &progress, 1},
+            {Options::DIRECTION.c_str(), required_argument, &direction, 1},
+            {Options::BMC_SCHEDULE.c_str(), required_argument, &bmcSchedule, 1},
             {0, 0, 0, 0}
         };
     while (true) {
@@ -99,9 +135,30 @@ Options CommandLineParser::parse(int argc, char ** argv) {
                     }
                 } else if (long_options[option_index].flag == &tpaUseQE) {
                     tpaUseQE = 1;
+                } else if (long_options[option_index].flag == &lawiBlockEncoding and optarg) {
+                    lawiBlockEncoding = isDisableKeyword(optarg) ? 0 : 1;
+                } else if (long_options[option_index].flag == &kindSimplePath and optarg) {
+                    kindSimplePath = isDisableKeyword(optarg) ? 0 : 1;
+                } else if (long_options[option_index].flag == &kindAuxInvariants and optarg) {
+                    kindAuxInvariants = isDisableKeyword(optarg) ? 0 : 1;
+                } else if (long_options[option_index].flag == &dumpQueries) {
+                    assert(optarg);
+                    res.addOption(Options::DUMP_QUERIES, optarg);
+                } else if (long_options[option_index].flag == &trace) {
+                    assert(optarg);
+                    res.addOption(Options::TRACE, optarg);
+                } else if (long_options[option_index].flag == &progress) {
+                    assert(optarg);
+                    res.addOption(Options::PROGRESS, optarg);
+                } else if (long_options[option_index].flag == &direction) {
+                    assert(optarg);
+                    res.addOption(Options::DIRECTION, optarg);
+                } else if (long_options[option_index].flag == &bmcSchedule) {
+                    assert(optarg);
+                    res.addOption(Options::BMC_SCHEDULE, optarg);
                 } else if (long_options[option_index].flag == &lraItpAlg) {
                     assert(optarg);
-                    lraItpAlg = std::atoi(optarg);
+                    res.addOption(Options::LRA_ITP_ALG, optarg);
                 }
                 else if (long_options[option_index].flag == &verbose) {
                     assert(optarg);
@@ -157,7 +214,18 @@ Options CommandLineParser::parse(int argc, char ** argv) {
     if (tpaUseQE) {
         res.addOption(Options::TPA_USE_QE, "true");
     }
-    res.addOption(Options::LRA_ITP_ALG, std::to_string(lraItpAlg));
+    if (lawiBlockEncoding) {
+        res.addOption(Options::LAWI_BLOCK_ENCODING, "true");
+    }
+    if (kindSimplePath) {
+        res.addOption(Options::KIND_SIMPLE_PATH, "true");
+    }
+    if (kindAuxInvariants) {
+        res.addOption(Options::KIND_AUX_INVARIANTS, "true");
+    }
+    if (not res.hasOption(Options::LRA_ITP_ALG)) {
+        res.addOption(Options::LRA_ITP_ALG, std::to_string(lraItpAlg));
+    }
     res.addOption(Options::VERBOSE, std::to_string(verbose));
 
     return res;
@@ -38,6 +38,14 @@ public:
     static const std::string FORCED_COVERING;
     static const std::string VERBOSE;
     static const std::string TPA_USE_QE;
+    static const std::string LAWI_BLOCK_ENCODING;
+    static const std::string KIND_SIMPLE_PATH;
+    static const std::string KIND_AUX_INVARIANTS;
+    static const std::string DUMP_QUERIES;
+    static const std::string TRACE;
+    static const std::string PROGRESS;
+    static const std::string DIRECTION;
+    static const std::string BMC_SCHEDULE;
 };
 
 class CommandLineParser {
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Progress.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#include <pthread.h>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Channel {
+    Progress::Callback callback;
+    std::chrono::duration<double> interval{0};
+    Clock::time_point start;
+    std::optional<Clock::time_point> lastDelivered;
+    // Newest report suppressed by the rate limit, waiting for the timer
+    std::optional<Progress::Report> pending;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::thread * timer = nullptr;
+    bool stopping = false;
+
+    ~Channel() { stopTimer(); }
+
+    // Must be called with the mutex held
+    void deliver(Progress::Report const & report) {
+        lastDelivered = Clock::now();
+        pending.reset();
+        if (callback) { callback(report); }
+    }
+
+    void runTimer() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (not stopping) {
+            if (not pending.has_value()) {
+                wakeUp.wait(lock);
+                continue;
+            }
+            auto due = lastDelivered.value() + std::chrono::duration_cast<Clock::duration>(interval);
+            if (Clock::now() >= due) {
+                deliver(pending.value());
+            } else {
+                wakeUp.wait_until(lock, due);
+            }
+        }
+    }
+
+    // Must be called with the mutex held
+    void ensureTimer() {
+        if (timer) { return; }
+        static std::once_flag forkHandlers;
+        std::call_once(forkHandlers, []() {
+            // The timer thread does not exist in a forked child; the child starts its own when it needs one
+            pthread_atfork(
+                []() { instance().mutex.lock(); },
+                []() { instance().mutex.unlock(); },
+                []() {
+                    auto & channel = instance();
+                    channel.timer = nullptr; // Deliberately leaked, the thread belongs to the parent
+                    channel.stopping = false;
+                    channel.mutex.unlock();
+                });
+        });
+        stopping = false;
+        timer = new std::thread([this]() { runTimer(); });
+    }
+
+    void stopTimer() {
+        std::thread * running = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            std::swap(running, timer);
+        }
+        wakeUp.notify_all();
+        if (running) {
+            running->join();
+            delete running;
+        }
+    }
+
+    static Channel & instance();
+};
+
+Channel & Channel::instance() {
+    static Channel channel;
+    return channel;
+}
+
+Channel & channel() {
+    return Channel::instance();
+}
+}
+
+void Progress::enable(Callback callback, double interval) {
+    auto & current = channel();
+    std::lock_guard<std::mutex> lock(current.mutex);
+    current.callback = std::move(callback);
+    current.interval = std::chrono::duration<double>(interval);
+    current.start = Clock::now();
+    current.lastDelivered.reset();
+    current.pending.reset();
+    enabled = true;
+}
+
+void Progress::enable(std::ostream & out, double interval) {
+    enable([&out](Report const & report) {
+        auto flags = out.flags();
+        auto precision = out.precision();
+        out << "{\"engine\":\"" << report.engine << "\",\"time\":" << std::fixed << std::setprecision(3) << report.time;
+        out.flags(flags);
+        out.precision(precision);
+        if (report.safeBound.has_value()) {
+            out << ",\"safe-up-to\":" << report.safeBound.value();
+        }
+        if (report.frontier.has_value()) {
+            out << ",\"frontier\":" << report.frontier.value();
+        }
+        out << "}" << std::endl;
+    }, interval);
+}
+
+void Progress::disable() {
+    auto & current = channel();
+    {
+        std::lock_guard<std::mutex> lock(current.mutex);
+        if (current.pending.has_value()) { current.deliver(current.pending.value()); }
+        enabled = false;
+        current.callback = nullptr;
+    }
+    current.stopTimer();
+}
+
+void Progress::report(char const * engine, std::optional<std::uint64_t> safeBound, std::optional<std::size_t> frontier) {
+    auto & current = channel();
+    std::lock_guard<std::mutex> lock(current.mutex);
+    if (not current.callback) { return; }
+    auto now = Clock::now();
+    std::chrono::duration<double> elapsed = now - current.start;
+    Report report{engine, elapsed.count(), safeBound, frontier};
+    if (current.lastDelivered.has_value() and now - current.lastDelivered.value() < current.interval) {
+        current.pending = report;
+        current.ensureTimer();
+        current.wakeUp.notify_all();
+        return;
+    }
+    current.deliver(report);
+}
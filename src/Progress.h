@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_PROGRESS_H
+#define GOLEM_PROGRESS_H
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+
+/*
+ * Anytime progress of a running engine.
+ *
+ * Engines report partial results as soon as they establish them: the bound up to which the system is known to be safe
+ * (no counterexample with at most that many steps, in the engine's own notion of a step) and the size of the current
+ * frontier (e.g., open leaves of an abstract reachability tree).
+ * Reports are rate-limited: at most one report is delivered per configured interval. A report arriving sooner is kept
+ * (replacing any older kept one) and delivered by a background timer as soon as the interval has passed, so the newest
+ * partial result is never held back for longer than the interval. Disabling delivers a kept report immediately.
+ * Delivery goes either to a callback or, on the command line, to one JSON object per line on stderr.
+ */
+class Progress {
+public:
+    struct Report {
+        char const * engine;
+        double time; // Seconds since progress reporting was enabled
+        std::optional<std::uint64_t> safeBound;
+        std::optional<std::size_t> frontier;
+    };
+
+    using Callback = std::function<void(Report const &)>;
+
+    static void enable(Callback callback, double interval);
+
+    // Writes the reports to the given stream as JSON lines
+    static void enable(std::ostream & out, double interval);
+
+    static void disable();
+
+    static bool isEnabled() { return enabled; }
+
+    static void report(char const * engine, std::optional<std::uint64_t> safeBound, std::optional<std::size_t> frontier);
+
+    // Bound 2^exponent, saturated at the maximal representable value
+    static std::uint64_t powerOfTwo(unsigned exponent) {
+        return exponent >= 64 ? UINT64_MAX : std::uint64_t(1) << exponent;
+    }
+
+private:
+    static inline bool enabled = false;
+};
+
+#define GOLEM_PROGRESS(engine, bound, frontier) \
+    if (Progress::isEnabled()) { Progress::report(engine, bound, frontier); }
+
+#endif //GOLEM_PROGRESS_H
@@ -4,18 +4,14 @@
 
 #include "QuantifierElimination.h"
 
+#include "FreeVariables.h"
 #include "ModelBasedProjection.h"
+#include "QueryDump.h"
 #include "TermUtils.h"
 
 
 PTRef QuantifierElimination::keepOnly(PTRef fla, const vec<PTRef> & varsToKeep) {
-    auto allVars = TermUtils(logic).getVars(fla);
-    vec<PTRef> toEliminate;
-    for (PTRef var : allVars) {
-        if (std::find(varsToKeep.begin(), varsToKeep.end(), var) == varsToKeep.end()) {
-            toEliminate.push(var);
-        }
-    }
+    vec<PTRef> toEliminate = FreeVariables::of(logic, fla).minus(VariableSet(varsToKeep)).toVec();
     return eliminate(fla, toEliminate);
 }
 
@@ -37,7 +33,7 @@ PTRef QuantifierElimination::eliminate(PTRef fla, vec<PTRef> const & vars) {
     MainSolver solver(logic, config, "QE solver");
     solver.insertFormula(fla);
     while(true) {
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "qe.model");
         if (res == s_False) {
             break;
         } else if (res == s_True) {
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "QueryDump.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+struct DumpSettings {
+    bool enabled = false;
+    std::filesystem::path directory;
+    std::string engine;
+    std::atomic<std::size_t> written{0};
+};
+
+DumpSettings & settings() {
+    static DumpSettings instance;
+    return instance;
+}
+
+char const * resultName(sstat result) {
+    if (result == s_True) { return "sat"; }
+    if (result == s_False) { return "unsat"; }
+    if (result == s_Undef) { return "unknown"; }
+    return "error";
+}
+
+void write(MainSolver & solver, char const * site, double seconds, sstat result) {
+    auto & dump = settings();
+    std::ostringstream name;
+    name << std::setw(6) << std::setfill('0') << dump.written++ << '_' << dump.engine << '_' << site << ".smt2";
+    std::ofstream out(dump.directory / name.str());
+    if (not out) {
+        throw std::logic_error("Cannot write query dump to " + (dump.directory / name.str()).string());
+    }
+    out << "; engine: " << dump.engine << '\n';
+    out << "; site: " << site << '\n';
+    out << "; time: " << std::fixed << std::setprecision(6) << seconds << '\n';
+    out << "; result: " << resultName(result) << '\n';
+    Logic & logic = solver.getLogic();
+    logic.dumpHeaderToFile(out);
+    auto assertions = solver.getCurrentAssertions();
+    for (PTRef assertion : assertions) {
+        logic.dumpFormulaToFile(out, assertion);
+    }
+    out << "(check-sat)\n";
+}
+}
+
+void QueryDump::enable(std::string const & directory, std::string const & engine) {
+    auto & dump = settings();
+    dump.directory = directory;
+    dump.engine = engine;
+    std::filesystem::create_directories(dump.directory);
+    dump.enabled = true;
+}
+
+void QueryDump::useSubdirectory(std::string const & name) {
+    auto & dump = settings();
+    if (not dump.enabled) { return; }
+    dump.directory /= name;
+    std::filesystem::create_directories(dump.directory);
+    dump.written = 0;
+}
+
+bool QueryDump::isEnabled() {
+    return settings().enabled;
+}
+
+sstat QueryDump::check(MainSolver & solver, char const * site) {
+    if (not isEnabled()) { return solver.check(); }
+    auto start = std::chrono::steady_clock::now();
+    sstat result = solver.check();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    write(solver, site, elapsed.count(), result);
+    return result;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_QUERYDUMP_H
+#define GOLEM_QUERYDUMP_H
+
+#include "osmt_solver.h"
+
+#include <string>
+
+/*
+ * Dumping of SMT queries issued by the engines, for offline profiling with golem-replay.
+ *
+ * When enabled, every check goes through QueryDump::check, which writes the current assertions of the solver
+ * to a standalone SMT-LIB file in the dump directory. The file starts with comment lines recording the engine,
+ * the call site, the wall time of the check and its result.
+ * When disabled, QueryDump::check is just MainSolver::check.
+ */
+class QueryDump {
+public:
+    static void enable(std::string const & directory, std::string const & engine);
+
+    static bool isEnabled();
+
+    // Continues the dump in the given subdirectory of the dump directory, e.g., in a forked child process
+    static void useSubdirectory(std::string const & name);
+
+    static sstat check(MainSolver & solver, char const * site);
+};
+
+#endif //GOLEM_QUERYDUMP_H
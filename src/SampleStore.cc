@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "SampleStore.h"
+
+#include <algorithm>
+
+void SampleSet::addSample(std::shared_ptr<Model> model) {
+    if (capacity == 0 or not model) { return; }
+    if (samples.size() == capacity) {
+        samples.pop_back();
+    }
+    // Newest samples go first; they are the most likely to be relevant for the next query
+    samples.insert(samples.begin(), std::move(model));
+}
+
+std::shared_ptr<Model> SampleSet::findRefutation(PTRef antecedent, PTRef consequent) {
+    if (antecedent == logic.getTerm_false() or consequent == logic.getTerm_true()) { return nullptr; }
+    for (auto it = samples.begin(); it != samples.end(); ++it) {
+        Model & sample = **it;
+        if (sample.evaluate(consequent) != logic.getTerm_false()) { continue; }
+        if (sample.evaluate(antecedent) != logic.getTerm_true()) { continue; }
+        // Move the successful sample to the front, it is likely to refute also the following queries
+        std::rotate(samples.begin(), it, it + 1);
+        return samples.front();
+    }
+    return nullptr;
+}
+
+SampleSet & SampleStore::getSamples(SymRef predicate) {
+    auto it = samples.find(predicate);
+    if (it == samples.end()) {
+        it = samples.emplace(predicate, SampleSet(logic)).first;
+    }
+    return it->second;
+}
+
+bool SampleStore::refutes(SymRef predicate, PTRef antecedent, PTRef consequent) {
+    auto it = samples.find(predicate);
+    if (it == samples.end()) { return false; }
+    return it->second.refutes(antecedent, consequent);
+}
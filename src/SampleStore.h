@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_SAMPLESTORE_H
+#define GOLEM_SAMPLESTORE_H
+
+#include "osmt_solver.h"
+#include "osmt_terms.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Collection of concrete assignments (samples) obtained from satisfiable solver queries.
+ *
+ * Any assignment that satisfies A and falsifies C is a witness that A does not imply C.
+ * Evaluating a formula in a stored model is much cheaper than a solver call, so implication checks
+ * should first consult the samples and go to the solver only if no sample refutes the implication.
+ *
+ * The set keeps only a bounded number of the most recent (or most recently useful) samples.
+ */
+class SampleSet {
+    Logic & logic;
+    std::size_t capacity;
+    std::vector<std::shared_ptr<Model>> samples;
+public:
+    static constexpr std::size_t defaultCapacity = 16;
+
+    explicit SampleSet(Logic & logic, std::size_t capacity = defaultCapacity) : logic(logic), capacity(capacity) {}
+
+    void addSample(std::shared_ptr<Model> model);
+
+    /*
+     * Returns true if some stored sample satisfies the antecedent and falsifies the consequent.
+     * A negative answer does not say anything about the validity of the implication.
+     */
+    bool refutes(PTRef antecedent, PTRef consequent) { return findRefutation(antecedent, consequent) != nullptr; }
+
+    /*
+     * Returns the stored sample that satisfies the antecedent and falsifies the consequent, or nullptr if there is none.
+     */
+    std::shared_ptr<Model> findRefutation(PTRef antecedent, PTRef consequent);
+
+    std::size_t size() const { return samples.size(); }
+};
+
+/*
+ * Samples partitioned by the predicate (vertex) whose states they represent.
+ */
+class SampleStore {
+    Logic & logic;
+    std::unordered_map<SymRef, SampleSet, SymRefHash> samples;
+
+public:
+    explicit SampleStore(Logic & logic) : logic(logic) {}
+
+    SampleSet & getSamples(SymRef predicate);
+
+    void addSample(SymRef predicate, std::shared_ptr<Model> model) { getSamples(predicate).addSample(std::move(model)); }
+
+    bool refutes(SymRef predicate, PTRef antecedent, PTRef consequent);
+};
+
+#endif //GOLEM_SAMPLESTORE_H
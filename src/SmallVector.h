@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_SMALLVECTOR_H
+#define GOLEM_SMALLVECTOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Sequence of trivially copyable elements that keeps up to N elements inline and moves to the heap only when it grows
+ * beyond that. Bodies of Horn clauses have almost always at most two predicates, so storing them inline avoids one
+ * allocation per clause.
+ */
+template<typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector supports only trivially copyable elements");
+    static_assert(N > 0, "SmallVector needs at least one inline element");
+
+    T * elements;
+    std::size_t count = 0;
+    std::size_t allocated = N;
+    alignas(T) unsigned char inlineStorage[N * sizeof(T)];
+
+    T * inlineElements() { return reinterpret_cast<T *>(inlineStorage); }
+    bool isInline() const { return elements == reinterpret_cast<T const *>(inlineStorage); }
+
+    void release() {
+        if (not isInline()) { delete[] reinterpret_cast<unsigned char *>(elements); }
+        elements = inlineElements();
+        allocated = N;
+        count = 0;
+    }
+
+    void copyFrom(SmallVector const & other) {
+        reserve(other.count);
+        if (other.count > 0) { std::memcpy(elements, other.elements, other.count * sizeof(T)); }
+        count = other.count;
+    }
+
+    void moveFrom(SmallVector & other) {
+        if (other.isInline()) {
+            copyFrom(other);
+        } else {
+            elements = other.elements;
+            allocated = other.allocated;
+            count = other.count;
+            other.elements = other.inlineElements();
+            other.allocated = N;
+        }
+        other.count = 0;
+    }
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = T *;
+    using const_iterator = T const *;
+
+    SmallVector() : elements(inlineElements()) {}
+
+    SmallVector(std::initializer_list<T> init) : SmallVector(init.begin(), init.end()) {}
+
+    template<typename TIt, typename = typename std::iterator_traits<TIt>::iterator_category>
+    SmallVector(TIt first, TIt last) : SmallVector() {
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    SmallVector(SmallVector const & other) : SmallVector() { copyFrom(other); }
+
+    SmallVector(SmallVector && other) noexcept : SmallVector() { moveFrom(other); }
+
+    SmallVector & operator=(SmallVector const & other) {
+        if (this != &other) {
+            count = 0;
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector & operator=(SmallVector && other) noexcept {
+        if (this != &other) {
+            release();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() { release(); }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::size_t capacity() const { return allocated; }
+
+    T * data() { return elements; }
+    T const * data() const { return elements; }
+
+    T & operator[](std::size_t index) { assert(index < count); return elements[index]; }
+    T const & operator[](std::size_t index) const { assert(index < count); return elements[index]; }
+
+    T & front() { assert(count > 0); return elements[0]; }
+    T const & front() const { assert(count > 0); return elements[0]; }
+    T & back() { assert(count > 0); return elements[count - 1]; }
+    T const & back() const { assert(count > 0); return elements[count - 1]; }
+
+    iterator begin() { return elements; }
+    iterator end() { return elements + count; }
+    const_iterator begin() const { return elements; }
+    const_iterator end() const { return elements + count; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    void reserve(std::size_t newCapacity) {
+        if (newCapacity <= allocated) { return; }
+        T * grown = reinterpret_cast<T *>(new unsigned char[newCapacity * sizeof(T)]);
+        if (count > 0) { std::memcpy(grown, elements, count * sizeof(T)); }
+        if (not isInline()) { delete[] reinterpret_cast<unsigned char *>(elements); }
+        elements = grown;
+        allocated = newCapacity;
+    }
+
+    void push_back(T const & value) {
+        if (count == allocated) {
+            // The value may live in the storage that is about to be reallocated
+            T copy = value;
+            reserve(2 * allocated);
+            elements[count++] = copy;
+        } else {
+            elements[count++] = value;
+        }
+    }
+
+    template<typename... TArgs>
+    T & emplace_back(TArgs &&... args) {
+        push_back(T{std::forward<TArgs>(args)...});
+        return back();
+    }
+
+    void pop_back() { assert(count > 0); --count; }
+
+    void clear() { count = 0; }
+};
+
+template<typename T, std::size_t N>
+bool operator==(SmallVector<T, N> const & first, SmallVector<T, N> const & second) {
+    return first.size() == second.size() and std::equal(first.begin(), first.end(), second.begin());
+}
+
+template<typename T, std::size_t N>
+bool operator!=(SmallVector<T, N> const & first, SmallVector<T, N> const & second) { return not(first == second); }
+
+#endif //GOLEM_SMALLVECTOR_H
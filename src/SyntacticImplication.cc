@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "SyntacticImplication.h"
+
+#include "TermUtils.h"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+struct Bound {
+    FastRational value;
+    bool strict;
+};
+
+/*
+ * Bounds on linear terms implied by a conjunction of literals.
+ * Inequalities are normalized by OpenSMT to the form "c <= t" with constant c; the negation "not (c <= t)" is "t < c".
+ */
+class BoundIndex {
+    ArithLogic & logic;
+    std::unordered_map<PTRef, Bound, PTRefHash> lower;
+    std::unordered_map<PTRef, Bound, PTRefHash> upper;
+    bool inconsistent = false;
+
+    // A bound on a term is also registered as the opposite bound on the negated term, because the normalized
+    // form of an inequality may use either of them
+    void addLower(PTRef term, FastRational const & value, bool strict) {
+        addLowerOnly(term, value, strict);
+        addUpperOnly(logic.mkNeg(term), -value, strict);
+    }
+
+    void addUpper(PTRef term, FastRational const & value, bool strict) {
+        addUpperOnly(term, value, strict);
+        addLowerOnly(logic.mkNeg(term), -value, strict);
+    }
+
+    void addLowerOnly(PTRef term, FastRational const & value, bool strict) {
+        auto it = lower.find(term);
+        if (it == lower.end()) {
+            lower.insert({term, Bound{value, strict}});
+        } else if (value > it->second.value or (value == it->second.value and strict)) {
+            it->second = Bound{value, strict};
+        }
+        checkConsistency(term);
+    }
+
+    void addUpperOnly(PTRef term, FastRational const & value, bool strict) {
+        auto it = upper.find(term);
+        if (it == upper.end()) {
+            upper.insert({term, Bound{value, strict}});
+        } else if (value < it->second.value or (value == it->second.value and strict)) {
+            it->second = Bound{value, strict};
+        }
+        checkConsistency(term);
+    }
+
+    void checkConsistency(PTRef term) {
+        auto lit = lower.find(term);
+        auto uit = upper.find(term);
+        if (lit == lower.end() or uit == upper.end()) { return; }
+        auto const & l = lit->second;
+        auto const & u = uit->second;
+        if (l.value > u.value or (l.value == u.value and (l.strict or u.strict))) {
+            inconsistent = true;
+        }
+    }
+
+public:
+    explicit BoundIndex(ArithLogic & logic) : logic(logic) {}
+
+    void add(PTRef literal) {
+        bool negated = logic.isNot(literal);
+        PTRef atom = negated ? logic.getPterm(literal)[0] : literal;
+        if (logic.isLeq(atom)) {
+            auto [constant, term] = logic.leqToConstantAndTerm(atom);
+            if (not logic.isNumConst(constant)) { return; }
+            if (negated) {
+                addUpper(term, logic.getNumConst(constant), true);
+            } else {
+                addLower(term, logic.getNumConst(constant), false);
+            }
+        } else if (logic.isNumEq(atom) and not negated) {
+            PTRef lhs = logic.getPterm(atom)[0];
+            PTRef rhs = logic.getPterm(atom)[1];
+            if (logic.isNumConst(lhs) == logic.isNumConst(rhs)) { return; }
+            PTRef constant = logic.isNumConst(lhs) ? lhs : rhs;
+            PTRef term = logic.isNumConst(lhs) ? rhs : lhs;
+            addLower(term, logic.getNumConst(constant), false);
+            addUpper(term, logic.getNumConst(constant), false);
+        }
+    }
+
+    bool isInconsistent() const { return inconsistent; }
+
+    bool entails(PTRef literal) const {
+        bool negated = logic.isNot(literal);
+        PTRef atom = negated ? logic.getPterm(literal)[0] : literal;
+        if (not logic.isLeq(atom)) { return false; }
+        auto [constant, term] = logic.leqToConstantAndTerm(atom);
+        if (not logic.isNumConst(constant)) { return false; }
+        auto const & value = logic.getNumConst(constant);
+        if (negated) { // need t < c
+            auto it = upper.find(term);
+            if (it == upper.end()) { return false; }
+            return it->second.value < value or (it->second.value == value and it->second.strict);
+        } else { // need c <= t
+            auto it = lower.find(term);
+            if (it == lower.end()) { return false; }
+            return it->second.value >= value;
+        }
+    }
+};
+}
+
+SyntacticImplication::Answer SyntacticImplication::check(PTRef antecedent, PTRef consequent) const {
+    if (antecedent == consequent or antecedent == logic.getTerm_false() or consequent == logic.getTerm_true()) {
+        return Answer::VALID;
+    }
+    if (logic.isOr(antecedent)) {
+        auto const & disjuncts = TermUtils(logic).getTopLevelDisjuncts(antecedent);
+        bool allValid = std::all_of(disjuncts.begin(), disjuncts.end(), [&](PTRef disjunct) {
+            return checkConjunctive(disjunct, consequent) == Answer::VALID;
+        });
+        return allValid ? Answer::VALID : Answer::UNKNOWN;
+    }
+    return checkConjunctive(antecedent, consequent);
+}
+
+SyntacticImplication::Answer SyntacticImplication::checkConjunctive(PTRef antecedent, PTRef consequent) const {
+    if (antecedent == consequent or antecedent == logic.getTerm_false() or consequent == logic.getTerm_true()) {
+        return Answer::VALID;
+    }
+    TermUtils utils(logic);
+    auto antecedentConjuncts = utils.getTopLevelConjuncts(antecedent);
+    std::unordered_set<PTRef, PTRefHash> known(antecedentConjuncts.begin(), antecedentConjuncts.end());
+    if (known.count(logic.getTerm_false()) > 0) { return Answer::VALID; }
+    auto * arithLogic = dynamic_cast<ArithLogic *>(&logic);
+    std::optional<BoundIndex> bounds;
+    if (arithLogic) {
+        bounds.emplace(*arithLogic);
+        for (PTRef conjunct : antecedentConjuncts) {
+            bounds->add(conjunct);
+        }
+        if (bounds->isInconsistent()) { return Answer::VALID; }
+    }
+    auto entailed = [&](PTRef literal) {
+        return literal == logic.getTerm_true() or known.count(literal) > 0 or (bounds.has_value() and bounds->entails(literal));
+    };
+    auto consequentConjuncts = utils.getTopLevelConjuncts(consequent);
+    for (PTRef conjunct : consequentConjuncts) {
+        if (entailed(conjunct)) { continue; }
+        if (logic.isOr(conjunct)) {
+            auto disjuncts = utils.getTopLevelDisjuncts(conjunct);
+            if (std::any_of(disjuncts.begin(), disjuncts.end(), entailed)) { continue; }
+        }
+        return Answer::UNKNOWN;
+    }
+    return Answer::VALID;
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_SYNTACTICIMPLICATION_H
+#define GOLEM_SYNTACTICIMPLICATION_H
+
+#include "osmt_terms.h"
+
+/*
+ * Cheap, incomplete check of validity of implications, meant to be consulted before running a solver.
+ *
+ * The antecedent is split into top-level conjuncts, and linear inequalities among them are indexed by their
+ * (normalized) linear term. Every conjunct of the consequent must then be either present among the conjuncts
+ * of the antecedent or entailed by a bound on the same linear term.
+ * Disjunctive antecedents are handled disjunct by disjunct, disjunctive consequents need one entailed disjunct.
+ *
+ * The check is sound, but it never proves that an implication does not hold.
+ */
+class SyntacticImplication {
+    Logic & logic;
+public:
+    enum class Answer : char { VALID, UNKNOWN };
+
+    explicit SyntacticImplication(Logic & logic) : logic(logic) {}
+
+    Answer check(PTRef antecedent, PTRef consequent) const;
+
+    bool isValid(PTRef antecedent, PTRef consequent) const { return check(antecedent, consequent) == Answer::VALID; }
+
+private:
+    Answer checkConjunctive(PTRef antecedent, PTRef consequent) const;
+};
+
+#endif //GOLEM_SYNTACTICIMPLICATION_H
@@ -608,4 +608,78 @@ PTRef VersionManager::sourceFormulaToTarget(PTRef fla) const {
     return rewrite(fla, [this](PTRef var) {
         return toTarget(toBase(var));
     });
-}
\ No newline at end of file
+}
+
+void SubstitutionContext::extend(TermUtils::substitutions_map const & additional) {
+    std::vector<PTRef> added;
+    for (auto const & [var, value] : additional) {
+        auto [it, inserted] = substitutions.insert({var, value});
+        if (inserted) {
+            added.push_back(var);
+        } else if (it->second != value) {
+            // The meaning of an existing substitution changed, nothing remembered can be trusted
+            it->second = value;
+            rewritten.clear();
+        }
+    }
+    if (added.empty() or rewritten.empty()) { return; }
+    VariableSet newlySubstituted(std::move(added));
+    for (auto it = rewritten.begin(); it != rewritten.end();) {
+        if (FreeVariables::of(logic, it->first).intersect(newlySubstituted).empty()) {
+            ++it;
+        } else {
+            it = rewritten.erase(it);
+        }
+    }
+}
+
+PTRef SubstitutionContext::apply(PTRef root) {
+    // Post-order traversal; a term is rewritten when all its children have been
+    std::vector<std::pair<PTRef, bool>> stack{{root, false}};
+    while (not stack.empty()) {
+        auto [term, expanded] = stack.back();
+        if (rewritten.count(term) > 0) {
+            stack.pop_back();
+            continue;
+        }
+        auto substituted = substitutions.find(term);
+        if (substituted != substitutions.end()) {
+            rewritten.insert({term, substituted->second});
+            stack.pop_back();
+            continue;
+        }
+        Pterm const & pterm = logic.getPterm(term);
+        if (pterm.size() == 0) {
+            rewritten.insert({term, term});
+            stack.pop_back();
+            continue;
+        }
+        if (not expanded) {
+            stack.back().second = true;
+            for (PTRef child : pterm) {
+                if (rewritten.count(child) == 0) { stack.push_back({child, false}); }
+            }
+            continue;
+        }
+        stack.pop_back();
+        vec<PTRef> args;
+        bool changed = false;
+        for (PTRef child : pterm) {
+            PTRef newChild = rewritten.at(child);
+            changed = changed or newChild != child;
+            args.push(newChild);
+        }
+        SymRef symbol = pterm.symb();
+        rewritten.insert({term, changed ? logic.insertTerm(symbol, std::move(args)) : term});
+    }
+    return rewritten.at(root);
+}
+
+std::vector<PTRef> SubstitutionContext::apply(std::vector<PTRef> const & roots) {
+    std::vector<PTRef> results;
+    results.reserve(roots.size());
+    for (PTRef root : roots) {
+        results.push_back(apply(root));
+    }
+    return results;
+}
@@ -7,6 +7,7 @@
 #ifndef OPENSMT_TERMUTILS_H
 #define OPENSMT_TERMUTILS_H
 
+#include "FreeVariables.h"
 #include "osmt_terms.h"
 
 #include <algorithm>
@@ -24,8 +25,9 @@ public:
         return logic.isUP(term) || (logic.hasSortBool(term) && logic.getPterm(term).nargs() == 0);
     }
 
+    // Free variables of the term, ordered by the term index
     vec<PTRef> getVars(PTRef term) const {
-        return ::variables(logic, term);
+        return FreeVariables::of(logic, term).toVec();
     }
 
     std::vector<PTRef> predicateArgsInOrder(PTRef predicate) const {
@@ -161,6 +163,31 @@ public:
     SimplificationResult extractSubstitutionsAndSimplify(PTRef fla);
 };
 
+/*
+ * Substitution of variables that remembers the results for all subterms it has rewritten.
+ *
+ * Unlike TermUtils::varSubstitute, which starts from scratch on every call, the context can be applied to many
+ * formulas and the shared subterms are rewritten only once. The substitution map can be extended by new variables;
+ * only the results for terms containing the newly substituted variables are forgotten.
+ * Rewriting creates terms in the Logic, so a context must not be used concurrently.
+ */
+class SubstitutionContext {
+    Logic & logic;
+    TermUtils::substitutions_map substitutions;
+    std::unordered_map<PTRef, PTRef, PTRefHash> rewritten;
+
+public:
+    explicit SubstitutionContext(Logic & logic, TermUtils::substitutions_map substitutions = {})
+        : logic(logic), substitutions(std::move(substitutions)) {}
+
+    void extend(TermUtils::substitutions_map const & additional);
+
+    PTRef apply(PTRef term);
+
+    // Rewrites every root in turn; subterms shared between the roots are rewritten only once
+    std::vector<PTRef> apply(std::vector<PTRef> const & roots);
+};
+
 class LATermUtils {
     ArithLogic & logic;
 public:
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Tracing.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+struct Event {
+    std::string name;
+    std::string detail;
+    char phase;
+    long long timestamp;
+    std::size_t thread;
+};
+
+struct Trace {
+    std::string file;
+    std::chrono::steady_clock::time_point start;
+    std::vector<Event> events;
+    std::unordered_map<std::thread::id, std::size_t> threadIds;
+    std::mutex mutex;
+};
+
+Trace & trace() {
+    static Trace instance;
+    return instance;
+}
+
+void record(std::string name, std::string detail, char phase) {
+    auto now = std::chrono::steady_clock::now();
+    auto & current = trace();
+    std::lock_guard<std::mutex> lock(current.mutex);
+    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(now - current.start).count();
+    // Small sequential thread ids are easier to read in the viewer than the native ones
+    auto thread = current.threadIds.insert({std::this_thread::get_id(), current.threadIds.size()}).first->second;
+    current.events.push_back(Event{std::move(name), std::move(detail), phase, timestamp, thread});
+}
+
+void writeEscaped(std::ostream & out, std::string const & text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+}
+
+void Tracing::enable(std::string const & file) {
+    auto & current = trace();
+    current.file = file;
+    current.start = std::chrono::steady_clock::now();
+    enabled = true;
+}
+
+void Tracing::useFileSuffix(std::string const & suffix) {
+    if (not enabled) { return; }
+    auto & current = trace();
+    std::lock_guard<std::mutex> lock(current.mutex);
+    std::filesystem::path file(current.file);
+    file.replace_filename(file.stem().string() + '.' + suffix + file.extension().string());
+    current.file = file.string();
+}
+
+void Tracing::begin(char const * name, std::string const & detail) {
+    record(name, detail, 'B');
+}
+
+void Tracing::end(char const * name) {
+    record(name, "", 'E');
+}
+
+void Tracing::instant(std::string const & message) {
+    record(message, "", 'i');
+}
+
+void Tracing::flush() {
+    if (not enabled) { return; }
+    auto & current = trace();
+    std::lock_guard<std::mutex> lock(current.mutex);
+    std::ofstream out(current.file);
+    if (not out) {
+        throw std::logic_error("Cannot write trace to " + current.file);
+    }
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (auto const & event : current.events) {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        first = false;
+        writeEscaped(out, event.name);
+        out << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.timestamp << ",\"pid\":1,\"tid\":" << event.thread;
+        if (event.phase == 'i') {
+            out << ",\"s\":\"t\"";
+        }
+        if (not event.detail.empty()) {
+            out << ",\"args\":{\"detail\":";
+            writeEscaped(out, event.detail);
+            out << '}';
+        }
+        out << '}';
+    }
+    out << "\n]}\n";
+}
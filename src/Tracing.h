@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_TRACING_H
+#define GOLEM_TRACING_H
+
+#include <sstream>
+#include <string>
+
+/*
+ * Timeline tracing in the Chrome trace-event format (viewable in Perfetto or chrome://tracing).
+ *
+ * Phases are marked with GOLEM_TRACE_SCOPE, which emits a begin event when the scope is entered and the matching end
+ * event when it is left; GOLEM_TRACE_INSTANT emits a single event with a message.
+ * Events are collected in memory and written to the file given to Tracing::enable by Tracing::flush.
+ * When tracing is not enabled at runtime, the macros cost a single test of a flag; the message of an instant event
+ * and the detail of a scope are not even computed. Building with GOLEM_NO_TRACING removes the macros completely.
+ */
+class Tracing {
+    static inline bool enabled = false;
+
+public:
+    static void enable(std::string const & file);
+
+    static bool isEnabled() { return enabled; }
+
+    static void begin(char const * name, std::string const & detail);
+
+    static void end(char const * name);
+
+    static void instant(std::string const & message);
+
+    // Writes all events collected so far to the trace file
+    static void flush();
+
+    // Inserts the suffix before the extension of the trace file, e.g., for the trace of a forked child process
+    static void useFileSuffix(std::string const & suffix);
+};
+
+class TraceScope {
+    char const * name;
+    bool active;
+
+public:
+    explicit TraceScope(char const * name) : name(name), active(Tracing::isEnabled()) {
+        if (active) { Tracing::begin(name, ""); }
+    }
+
+    template<typename TDetail>
+    TraceScope(char const * name, TDetail detail) : name(name), active(Tracing::isEnabled()) {
+        if (active) { Tracing::begin(name, detail()); }
+    }
+
+    TraceScope(TraceScope const &) = delete;
+    TraceScope & operator=(TraceScope const &) = delete;
+
+    ~TraceScope() {
+        if (active) { Tracing::end(name); }
+    }
+};
+
+#ifdef GOLEM_NO_TRACING
+#define GOLEM_TRACE_SCOPE(name)
+#define GOLEM_TRACE_SCOPE_DETAIL(name, m)
+#define GOLEM_TRACE_INSTANT(m)
+#else
+#define GOLEM_TRACE_CONCAT_IMPL(a, b) a##b
+#define GOLEM_TRACE_CONCAT(a, b) GOLEM_TRACE_CONCAT_IMPL(a, b)
+#define GOLEM_TRACE_SCOPE(name) TraceScope GOLEM_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define GOLEM_TRACE_SCOPE_DETAIL(name, m) \
+    TraceScope GOLEM_TRACE_CONCAT(traceScope, __LINE__)(name, [&]() { std::ostringstream detail; detail << m; return detail.str(); })
+#define GOLEM_TRACE_INSTANT(m) \
+    do { \
+        if (Tracing::isEnabled()) { std::ostringstream traceMessage; traceMessage << m; Tracing::instant(traceMessage.str()); } \
+    } while (0)
+#endif
+
+#endif //GOLEM_TRACING_H
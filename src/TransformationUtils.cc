@@ -3,7 +3,7 @@
 //
 
 #include "TransformationUtils.h"
-#include "QuantifierElimination.h"
+#include "FreeVariables.h"
 
 bool isTransitionSystem(ChcDirectedGraph const & graph) {
     auto graphRepresentation = AdjacencyListsGraphRepresentation::from(graph);
@@ -47,6 +47,20 @@ std::unique_ptr<TransitionSystem> toTransitionSystem(ChcDirectedGraph const & gr
     PTRef init = PTRef_Undef;
     PTRef transitionRelation = PTRef_Undef;
     PTRef bad = PTRef_Undef;
+    std::vector<PTRef> initAuxiliaryVars;
+    std::vector<PTRef> badAuxiliaryVars;
+    // Local variables of init and query stay existentially quantified; fresh names keep them apart from each other
+    auto renameAuxiliaryVars = [&](PTRef fla, std::string const & prefix, std::vector<PTRef> & auxiliaryVars) {
+        TimeMachine tm(logic);
+        TermUtils::substitutions_map subst;
+        for (PTRef var : FreeVariables::of(logic, fla).minus(VariableSet(stateVars))) {
+            std::string name = "ts::" + prefix + std::to_string(auxiliaryVars.size());
+            PTRef renamed = tm.getVarVersionZero(name, logic.getSortRef(var));
+            auxiliaryVars.push_back(renamed);
+            subst.insert({var, renamed});
+        }
+        return subst.empty() ? fla : TermUtils(logic).varSubstitute(fla, subst);
+    };
     graph.forEachEdge([&](DirectedEdge const & edge) {
         auto source = edge.from;
         auto target = edge.to;
@@ -61,7 +75,7 @@ std::unique_ptr<TransitionSystem> toTransitionSystem(ChcDirectedGraph const & gr
             std::transform(edgeVars.nextStateVars.begin(), edgeVars.nextStateVars.end(), stateVars.begin(), std::inserter(subMap, subMap.end()),
                            [](PTRef key, PTRef value) { return std::make_pair(key, value); });
             init = utils.varSubstitute(fla, subMap);
-            init = QuantifierElimination(logic).keepOnly(init, stateVars);
+            init = renameAuxiliaryVars(init, "init_aux", initAuxiliaryVars);
 //            std::cout << logic.printTerm(init) << std::endl;
         }
         if (isLoop) {
@@ -73,12 +87,12 @@ std::unique_ptr<TransitionSystem> toTransitionSystem(ChcDirectedGraph const & gr
             std::transform(edgeVars.stateVars.begin(), edgeVars.stateVars.end(), stateVars.begin(), std::inserter(subMap, subMap.end()),
                            [](PTRef key, PTRef value) { return std::make_pair(key, value); });
             bad = utils.varSubstitute(fla, subMap);
-            bad = QuantifierElimination(logic).keepOnly(bad, stateVars);
+            bad = renameAuxiliaryVars(bad, "query_aux", badAuxiliaryVars);
 //            std::cout << logic.printTerm(bad) << std::endl;
         }
     });
     assert(init != PTRef_Undef && transitionRelation != PTRef_Undef && bad != PTRef_Undef);
-    auto ts = std::unique_ptr<TransitionSystem>(new TransitionSystem(logic, std::move(systemType), init, transitionRelation, bad));
+    auto ts = std::unique_ptr<TransitionSystem>(new TransitionSystem(logic, std::move(systemType), init, std::move(initAuxiliaryVars), transitionRelation, bad, std::move(badAuxiliaryVars)));
     return ts;
 }
 
@@ -115,12 +129,9 @@ EdgeVariables getVariablesFromEdge(Logic & logic, ChcDirectedGraph const & graph
     res.stateVars = utils.predicateArgsInOrder(sourcePred);
     res.nextStateVars = utils.predicateArgsInOrder(targetPred);
     PTRef edgeLabel = graph.getEdgeLabel(eid);
-    auto allVars = TermUtils(logic).getVars(edgeLabel);
-    for (PTRef var : allVars) {
-        if (std::find(res.stateVars.begin(), res.stateVars.end(), var) == res.stateVars.end() and
-            std::find(res.nextStateVars.begin(), res.nextStateVars.end(), var) == res.nextStateVars.end()) {
-            res.auxiliaryVars.push_back(var);
-        }
+    auto predicateVars = VariableSet(res.stateVars).unite(VariableSet(res.nextStateVars));
+    for (PTRef var : FreeVariables::of(logic, edgeLabel).minus(predicateVars)) {
+        res.auxiliaryVars.push_back(var);
     }
     return res;
 }
@@ -7,19 +7,24 @@
 
 #include "TransitionSystem.h"
 
+#include "FreeVariables.h"
 #include "TermUtils.h"
 #include "QuantifierElimination.h"
+#include "QueryDump.h"
+
+#include <optional>
 
 bool TransitionSystem::isWellFormed() {
 //    return systemType->isStateFormula(init) && systemType->isStateFormula(query) && systemType->isTransitionFormula(transition);
-    bool ok = systemType->isStateFormula(init);
+    auto stateVars = VariableSet(systemType->getStateVars());
+    bool ok = FreeVariables::of(logic, init).isSubsetOf(stateVars.unite(VariableSet(initAuxiliaryVars)));
     if (not ok) {
         std::stringstream ss;
         TermUtils(logic).printTermWithLets(ss, init);
         std::cerr << "Problem in init:" << ss.str() << std::endl;
         return false;
     }
-    ok = systemType->isStateFormula(query);
+    ok = FreeVariables::of(logic, query).isSubsetOf(stateVars.unite(VariableSet(queryAuxiliaryVars)));
     if (not ok) {
         std::stringstream ss;
         TermUtils(logic).printTermWithLets(ss, query);
@@ -86,14 +91,7 @@ SystemType::SystemType(vec<PTRef> const & stateVars, vec<PTRef> const & auxiliar
 }
 
 bool SystemType::isStateFormula(PTRef fla) const {
-    auto const & currentStateVars = stateVars;
-    vec<PTRef> vars = TermUtils(logic).getVars(fla);
-    for (PTRef var : vars) {
-        if (std::find(std::begin(currentStateVars), std::end(currentStateVars), var) == std::end(currentStateVars)) {
-            return false;
-        }
-    }
-    return true;
+    return FreeVariables::of(logic, fla).isSubsetOf(VariableSet(stateVars));
 }
 
 bool SystemType::isTransitionFormula(PTRef fla) const {
@@ -102,18 +100,33 @@ bool SystemType::isTransitionFormula(PTRef fla) const {
     allVars.insert(allVars.end(), stateVars.begin(), stateVars.end());
     allVars.insert(allVars.end(), nextStateVars.begin(), nextStateVars.end());
     allVars.insert(allVars.end(), auxiliaryVars.begin(), auxiliaryVars.end());
-    vec<PTRef> vars = TermUtils(logic).getVars(fla);
-    return std::all_of(vars.begin(), vars.end(), [&allVars](PTRef var){
-        return std::find(std::begin(allVars), std::end(allVars), var) != std::end(allVars);
-    });
+    return FreeVariables::of(logic, fla).isSubsetOf(VariableSet(std::move(allVars)));
+}
+
+PTRef TransitionSystem::projectToStateVars(PTRef fla, std::vector<PTRef> const & auxiliaryVars) const {
+    if (auxiliaryVars.empty()) { return fla; }
+    vec<PTRef> stateVars;
+    for (PTRef var : systemType->getStateVars()) {
+        stateVars.push(var);
+    }
+    // Most auxiliary variables are defined by equalities and disappear without full quantifier elimination
+    PTRef res = TrivialQuantifierElimination(logic).tryEliminateVarsExcept(stateVars, fla);
+    if (systemType->isStateFormula(res)) { return res; }
+    return QuantifierElimination(logic).keepOnly(res, stateVars);
 }
 
 PTRef TransitionSystem::getInit() const {
-    return init;
+    if (projectedInit == PTRef_Undef) {
+        projectedInit = projectToStateVars(init, initAuxiliaryVars);
+    }
+    return projectedInit;
 }
 
 PTRef TransitionSystem::getQuery() const {
-    return query;
+    if (projectedQuery == PTRef_Undef) {
+        projectedQuery = projectToStateVars(query, queryAuxiliaryVars);
+    }
+    return projectedQuery;
 }
 
 PTRef TransitionSystem::getTransition() const {
@@ -137,11 +150,13 @@ std::vector<PTRef> TransitionSystem::getAuxiliaryVars() const {
 }
 
 TransitionSystem TransitionSystem::reverse(TransitionSystem const & original) {
-    PTRef reversedInitial = original.query;
-    PTRef reversedQuery = original.init;
     PTRef reversedTransition = reverseTransitionRelation(original);
     auto type = std::make_unique<SystemType>(*original.systemType);
-    return TransitionSystem(original.logic, std::move(type), reversedInitial, reversedTransition, reversedQuery);
+    TransitionSystem reversed(original.logic, std::move(type), original.query, original.queryAuxiliaryVars,
+                              reversedTransition, original.init, original.initAuxiliaryVars);
+    reversed.projectedInit = original.projectedQuery;
+    reversed.projectedQuery = original.projectedInit;
+    return reversed;
 }
 
 PTRef TransitionSystem::reverseTransitionRelation(TransitionSystem const & transitionSystem) {
@@ -178,7 +193,7 @@ PTRef TransitionSystem::reverseTransitionRelation(TransitionSystem const & trans
 }
 
 
-PTRef kinductiveToInductive(PTRef invariant, unsigned long k, TransitionSystem const & system) {
+PTRef kinductiveToInductiveByQE(PTRef invariant, unsigned long k, TransitionSystem const & system) {
     /*
      * If P(x) is k-inductive invariant then the following formula is 1-inductive invariant:
      * P(x_0)
@@ -232,4 +247,66 @@ PTRef kinductiveToInductive(PTRef invariant, unsigned long k, TransitionSystem c
         resArgs.push(logic.mkNot(afterElimination));
     }
     return logic.mkAnd(std::move(resArgs));
-}
\ No newline at end of file
+}
+
+/*
+ * QE-free construction based on interpolation over a single incremental solver.
+ *
+ * Let Good(x) be the initial states together with the states at the end of a path of k-1 transitions through P
+ * (all k states of the path in P).
+ * Every reachable state is in Good (P holds in all reachable states) and, since P is k-inductive, no state of Good
+ * can leave P. Hence Good is unsatisfiable together with Bad_j(x_0) = Tr(x_0,x_1) \land P(x_1) \land \ldots \land Tr(x_{j-1},x_j) \land \neg P(x_j)
+ * for every j, and the interpolants I_j between Good and Bad_j, for j from 1 to k-1, strengthen P towards the formula
+ * computed by kinductiveToInductiveByQE. The conjunction P \land I_1 \land \ldots \land I_{k-1} contains the initial states,
+ * but it is inductive only if the interpolants are precise enough, which is checked at the end.
+ */
+std::optional<PTRef> kinductiveToInductiveByInterpolation(PTRef invariant, unsigned long k, TransitionSystem const & system) {
+    Logic & logic = system.getLogic();
+    TimeMachine tm(logic);
+    PTRef transition = system.getTransition();
+    auto shift = static_cast<int>(k) - 1;
+    SMTConfig config;
+    const char * msg = "ok";
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    config.setSimplifyInterpolant(4);
+    MainSolver solver(logic, config, "k-inductive to inductive");
+    // Good states at version k-1, the path leading to them uses versions 0 to k-2
+    vec<PTRef> goodPath;
+    for (int i = 0; i < shift; ++i) {
+        goodPath.push(tm.sendFlaThroughTime(invariant, i));
+        goodPath.push(tm.sendFlaThroughTime(transition, i));
+    }
+    goodPath.push(tm.sendFlaThroughTime(invariant, shift));
+    solver.insertFormula(logic.mkOr(tm.sendFlaThroughTime(system.getInitWithAuxiliaries(), shift), logic.mkAnd(std::move(goodPath))));
+    ipartitions_t goodMask = 0;
+    opensmt::setbit(goodMask, 0);
+    vec<PTRef> resArgs;
+    resArgs.push(invariant);
+    for (unsigned long j = 1; j < k; ++j) {
+        auto version = shift + static_cast<int>(j);
+        solver.insertFormula(tm.sendFlaThroughTime(transition, version - 1));
+        solver.push();
+        solver.insertFormula(logic.mkNot(tm.sendFlaThroughTime(invariant, version)));
+        if (QueryDump::check(solver, "kinductive.itp") != s_False) { return std::nullopt; }
+        vec<PTRef> itps;
+        solver.getInterpolationContext()->getSingleInterpolant(itps, goodMask);
+        assert(itps.size() == 1);
+        resArgs.push(tm.sendFlaThroughTime(itps[0], -shift));
+        solver.pop();
+        solver.insertFormula(tm.sendFlaThroughTime(invariant, version));
+    }
+    PTRef candidate = logic.mkAnd(std::move(resArgs));
+    SMTConfig checkConfig;
+    MainSolver checker(logic, checkConfig, "inductiveness check");
+    checker.insertFormula(candidate);
+    checker.insertFormula(transition);
+    checker.insertFormula(logic.mkNot(tm.sendFlaThroughTime(candidate, 1)));
+    if (QueryDump::check(checker, "kinductive.check") != s_False) { return std::nullopt; }
+    return candidate;
+}
+
+PTRef kinductiveToInductive(PTRef invariant, unsigned long k, TransitionSystem const & system) {
+    if (k <= 1) { return kinductiveToInductiveByQE(invariant, k, system); }
+    auto inductive = kinductiveToInductiveByInterpolation(invariant, k, system);
+    return inductive.has_value() ? inductive.value() : kinductiveToInductiveByQE(invariant, k, system);
+}
@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <memory>
+#include <optional>
 
 class SystemType {
 
@@ -43,29 +44,53 @@ class TransitionSystem {
 
     std::unique_ptr<SystemType> systemType;
 
+    // Initial and bad states may contain auxiliary variables, which are implicitly existentially quantified.
+    // Projection to the state variables is computed only when some client asks for it.
     PTRef init;
+    std::vector<PTRef> initAuxiliaryVars;
     PTRef transition;
     PTRef query;
+    std::vector<PTRef> queryAuxiliaryVars;
 
+    mutable PTRef projectedInit = PTRef_Undef;
+    mutable PTRef projectedQuery = PTRef_Undef;
 
 public:
     TransitionSystem(Logic & logic, std::unique_ptr<SystemType> systemType,
         PTRef initialStates, PTRef transitionRelation, PTRef badStates) :
+        TransitionSystem(logic, std::move(systemType), initialStates, {}, transitionRelation, badStates, {}) {}
+
+    TransitionSystem(Logic & logic, std::unique_ptr<SystemType> systemType,
+        PTRef initialStates, std::vector<PTRef> initAuxiliaryVars, PTRef transitionRelation,
+        PTRef badStates, std::vector<PTRef> queryAuxiliaryVars) :
         logic(logic),
         systemType(std::move(systemType)),
         init(initialStates),
+        initAuxiliaryVars(std::move(initAuxiliaryVars)),
         transition(transitionRelation),
-        query(badStates)
+        query(badStates),
+        queryAuxiliaryVars(std::move(queryAuxiliaryVars))
     {
         if (not isWellFormed()) {
             throw std::logic_error("Transition system not created correctly");
         }
     }
 
+    /** Initial states as a pure state formula; auxiliary variables are eliminated on the first call */
     PTRef getInit() const;
+    /** Bad states as a pure state formula; auxiliary variables are eliminated on the first call */
     PTRef getQuery() const;
     PTRef getTransition() const;
 
+    /**
+     * Initial (bad) states over state variables and the auxiliary variables returned by getInitAuxiliaryVars
+     * (getQueryAuxiliaryVars). Suitable wherever the formula occurs only positively, e.g., in unrollings.
+     */
+    PTRef getInitWithAuxiliaries() const { return init; }
+    PTRef getQueryWithAuxiliaries() const { return query; }
+    std::vector<PTRef> const & getInitAuxiliaryVars() const { return initAuxiliaryVars; }
+    std::vector<PTRef> const & getQueryAuxiliaryVars() const { return queryAuxiliaryVars; }
+
     Logic & getLogic() const;
 
     std::vector<PTRef> getStateVars() const;
@@ -80,10 +105,16 @@ private:
     bool isWellFormed();
 
     PTRef toNextStateVar(PTRef var) const;
+
+    PTRef projectToStateVars(PTRef fla, std::vector<PTRef> const & auxiliaryVars) const;
 };
 
 PTRef kinductiveToInductive(PTRef invariant, unsigned long k, TransitionSystem const & system);
 
+// The two constructions used by kinductiveToInductive; exposed for testing
+PTRef kinductiveToInductiveByQE(PTRef invariant, unsigned long k, TransitionSystem const & system);
+std::optional<PTRef> kinductiveToInductiveByInterpolation(PTRef invariant, unsigned long k, TransitionSystem const & system);
+
 
 
 #endif //GOLEM_TRANSITIONSYSTEM_H
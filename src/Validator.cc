@@ -6,6 +6,8 @@
 
 #include "Validator.h"
 
+#include "QueryDump.h"
+
 Validator::Result Validator::validate(ChcDirectedHyperGraph const & graph, VerificationResult const & result) {
     switch (result.getAnswer()) {
         case VerificationAnswer::SAFE:
@@ -26,8 +28,12 @@ Validator::Result Validator::validateValidityWitness(ChcDirectedHyperGraph const
     }
     TermUtils utils(logic);
     ChcDirectedHyperGraph::VertexInstances vertexInstances(graph);
+    // The same instance of a predicate occurs in many edges, its interpretation is computed only once
+    std::unordered_map<PTRef, PTRef, PTRefHash> interpretations;
     // get correct interpretation for each node
     auto getInterpretation = [&](PTRef nodePredicate) -> PTRef {
+        auto known = interpretations.find(nodePredicate);
+        if (known != interpretations.end()) { return known->second; }
         auto symbol = logic.getSymRef(nodePredicate);
         auto it = std::find_if(definitions.begin(), definitions.end(),
                                [this,symbol](auto const & entry) {
@@ -42,7 +48,9 @@ Validator::Result Validator::validateValidityWitness(ChcDirectedHyperGraph const
         // build the substitution map
         std::unordered_map<PTRef, PTRef, PTRefHash> subst;
         utils.mapFromPredicate(it->first, nodePredicate, subst);
-        return utils.varSubstitute(definitionTemplate, subst);
+        PTRef interpretation = utils.varSubstitute(definitionTemplate, subst);
+        interpretations.insert({nodePredicate, interpretation});
+        return interpretation;
     };
 
     auto edges = graph.getEdges();
@@ -64,7 +72,7 @@ Validator::Result Validator::validateValidityWitness(ChcDirectedHyperGraph const
             SMTConfig config;
             MainSolver solver(logic, config, "validator");
             solver.insertFormula(query);
-            auto res = solver.check();
+            auto res = QueryDump::check(solver, "validator.validity");
             if (res != s_False) {
                 std::cerr << ";Edge not validated!";
                 // TODO: print edge
@@ -109,7 +117,7 @@ Validator::Result validateStep(
     SMTConfig config;
     MainSolver solver(logic, config, "validator");
     solver.insertFormula(constraintAfterSubstitution);
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "validator.invalidity");
     if (res == s_True) { return Validator::Result::VALIDATED; }
     return Validator::Result::NOT_VALIDATED;
 }
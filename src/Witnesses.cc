@@ -6,6 +6,7 @@
 
 #include "Witnesses.h"
 
+#include "QueryDump.h"
 #include "TransformationUtils.h"
 
 void VerificationResult::printWitness(std::ostream & out, Logic & logic) const {
@@ -41,7 +42,7 @@ InvalidityWitness InvalidityWitness::fromErrorPath(ErrorPath const & errorPath,
             fla = TimeMachine(logic).sendFlaThroughTime(fla, i);
             solver.insertFormula(fla);
         }
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "witness.error-path");
         if (res != s_True) { throw std::logic_error("Error in computing model for the error path"); }
         return solver.getModel();
     }();
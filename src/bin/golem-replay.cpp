@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Replays the SMT queries written by golem --dump-queries <dir> and reports per-call-site timing distributions.
+ *
+ * Usage: golem-replay <dir> [site-prefix]
+ */
+
+#include "osmt_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+struct Query {
+    std::filesystem::path file;
+    std::string engine;
+    std::string site;
+    double recordedTime = 0;
+    std::string recordedResult;
+};
+
+struct Replay {
+    double time;
+    bool resultMatches;
+};
+
+Query readHeader(std::filesystem::path const & file) {
+    Query query{file, "", "", 0, ""};
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line) and line.rfind("; ", 0) == 0) {
+        auto separator = line.find(": ");
+        if (separator == std::string::npos) { continue; }
+        std::string key = line.substr(2, separator - 2);
+        std::string value = line.substr(separator + 2);
+        if (key == "engine") { query.engine = value; }
+        else if (key == "site") { query.site = value; }
+        else if (key == "time") { query.recordedTime = std::stod(value); }
+        else if (key == "result") { query.recordedResult = value; }
+    }
+    return query;
+}
+
+Replay replay(Query const & query) {
+    FILE * fin = fopen(query.file.c_str(), "rt");
+    if (not fin) {
+        throw std::runtime_error("Cannot open " + query.file.string());
+    }
+    // The interpreter prints the result of (check-sat) to the standard output
+    std::ostringstream output;
+    auto * original = std::cout.rdbuf(output.rdbuf());
+    auto start = std::chrono::steady_clock::now();
+    {
+        SMTConfig config;
+        Interpret interpreter(config);
+        interpreter.interpFile(fin);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout.rdbuf(original);
+    fclose(fin);
+    std::istringstream results(output.str());
+    std::string result;
+    std::string word;
+    while (results >> word) {
+        if (word == "sat" or word == "unsat" or word == "unknown") { result = word; }
+    }
+    return Replay{elapsed.count(), result == query.recordedResult};
+}
+
+double percentile(std::vector<double> const & sorted, double fraction) {
+    auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+}
+
+int main(int argc, char * argv[]) {
+    if (argc < 2 or argc > 3) {
+        std::cerr << "Usage: golem-replay <dir> [site-prefix]\n";
+        return 1;
+    }
+    std::filesystem::path directory(argv[1]);
+    std::string sitePrefix = argc == 3 ? argv[2] : "";
+    if (not std::filesystem::is_directory(directory)) {
+        std::cerr << directory << " is not a directory\n";
+        return 1;
+    }
+    std::vector<std::filesystem::path> files;
+    for (auto const & entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".smt2") { files.push_back(entry.path()); }
+    }
+    std::sort(files.begin(), files.end());
+
+    struct SiteStats {
+        std::vector<double> replayed;
+        double recorded = 0;
+        std::size_t mismatches = 0;
+    };
+    std::map<std::pair<std::string, std::string>, SiteStats> stats;
+    for (auto const & file : files) {
+        Query query = readHeader(file);
+        if (query.site.rfind(sitePrefix, 0) != 0) { continue; }
+        Replay result = replay(query);
+        auto & site = stats[{query.engine, query.site}];
+        site.replayed.push_back(result.time);
+        site.recorded += query.recordedTime;
+        if (not result.resultMatches) {
+            ++site.mismatches;
+            std::cerr << "Result differs from the recorded one: " << file << '\n';
+        }
+    }
+
+    std::cout << std::left << std::setw(12) << "engine" << std::setw(32) << "site" << std::right
+              << std::setw(8) << "count" << std::setw(12) << "recorded" << std::setw(12) << "total"
+              << std::setw(12) << "mean" << std::setw(12) << "median" << std::setw(12) << "p90"
+              << std::setw(12) << "max" << std::setw(12) << "mismatch" << '\n';
+    std::cout << std::fixed << std::setprecision(4);
+    for (auto & [key, site] : stats) {
+        auto & times = site.replayed;
+        std::sort(times.begin(), times.end());
+        double total = 0;
+        for (double time : times) { total += time; }
+        std::cout << std::left << std::setw(12) << key.first << std::setw(32) << key.second << std::right
+                  << std::setw(8) << times.size() << std::setw(12) << site.recorded << std::setw(12) << total
+                  << std::setw(12) << total / static_cast<double>(times.size()) << std::setw(12) << percentile(times, 0.5)
+                  << std::setw(12) << percentile(times, 0.9) << std::setw(12) << times.back()
+                  << std::setw(12) << site.mismatches << '\n';
+    }
+    return 0;
+}
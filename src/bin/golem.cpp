@@ -5,11 +5,17 @@
  */
 
 #include "ChcInterpreter.h"
+#include "FreeVariables.h"
 #include "Options.h"
+#include "Progress.h"
+#include "QueryDump.h"
+#include "Tracing.h"
 
 #include "osmt_terms.h"
 #include "osmt_parser.h"
 
+#include <cmath>
+#include <cstdlib>
 #include <memory>
 
 namespace{
@@ -81,6 +87,32 @@ int main( int argc, char * argv[] ) {
     if (inputFile.empty()) {
         error("No input file provided");
     }
+    if (options.hasOption(Options::DUMP_QUERIES)) {
+        auto engine = options.hasOption(Options::ENGINE) ? options.getOption(Options::ENGINE) : "spacer";
+        QueryDump::enable(options.getOption(Options::DUMP_QUERIES), engine);
+    }
+    if (options.hasOption(Options::TRACE)) {
+        Tracing::enable(options.getOption(Options::TRACE));
+        // The trace is written however the run ends, also when an error terminates it early
+        std::atexit([]() {
+            try {
+                Tracing::flush();
+            } catch (std::exception const & e) {
+                std::cerr << e.what() << '\n';
+            }
+        });
+    }
+    if (options.hasOption(Options::PROGRESS)) {
+        auto const & value = options.getOption(Options::PROGRESS);
+        char * end = nullptr;
+        double interval = std::strtod(value.c_str(), &end);
+        if (value.empty() or *end != '\0' or not std::isfinite(interval) or interval < 0) {
+            error("Invalid progress interval specified: " + value);
+        }
+        Progress::enable(std::cerr, interval);
+        // The last rate-limited report is often the best result so far, it must not be lost when the run ends
+        std::atexit([]() { Progress::disable(); });
+    }
     {
         FILE * fin = nullptr;
         // check the file
@@ -94,15 +126,27 @@ int main( int argc, char * argv[] ) {
         const char * extension = strrchr( filename, '.' );
         if (extension != nullptr && strcmp(extension, ".smt2") == 0) {
             Smt2newContext context(fin);
-            int rval = smt2newparse(&context);
+            int rval = [&]() {
+                GOLEM_TRACE_SCOPE("parse");
+                return smt2newparse(&context);
+            }();
             if (rval != 0) {
                 fclose(fin);
                 error("Eror when parsing input file");
             }
             auto logicStr = options.hasOption(Options::LOGIC) ? options.getOption(Options::LOGIC) : tryDetectLogic(context.getRoot());
             auto logic = logicFromString(logicStr);
+            FreeVariables::Registration freeVariables(*logic);
             ChcInterpreter interpreter(options);
-            interpreter.interpretSystemAst(*logic, context.getRoot());
+            try {
+                GOLEM_TRACE_SCOPE("interpret");
+                interpreter.interpretSystemAst(*logic, context.getRoot());
+            } catch (...) {
+                // An escaping exception terminates the program without running the exit handlers
+                if (Progress::isEnabled()) { Progress::disable(); }
+                Tracing::flush();
+                throw;
+            }
             fclose(fin);
         }
         else {
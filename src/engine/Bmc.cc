@@ -5,21 +5,62 @@
  */
 
 #include "Bmc.h"
+#include "Progress.h"
+#include "QueryDump.h"
 #include "TermUtils.h"
 #include "TransformationUtils.h"
 
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <optional>
+#include <stdexcept>
+
+BMC::BMC(Logic & logic, Options const & options) : logic(logic) {
+    if (options.hasOption(Options::VERBOSE)) {
+        verbosity = std::stoi(options.getOption(Options::VERBOSE));
+    }
+    if (options.hasOption(Options::BMC_SCHEDULE)) {
+        std::string schedule = options.getOption(Options::BMC_SCHEDULE);
+        if (schedule == "geometric") {
+            geometricSchedule = true;
+        } else if (schedule != "linear") {
+            bool isNumber = not schedule.empty() and std::all_of(schedule.begin(), schedule.end(), [](char c) {
+                return std::isdigit(static_cast<unsigned char>(c));
+            });
+            try {
+                blockSize = isNumber ? std::stoul(schedule) : 0;
+            } catch (std::out_of_range const &) {
+                blockSize = 0;
+            }
+            if (blockSize == 0) {
+                throw std::invalid_argument("Unknown BMC schedule specified");
+            }
+        }
+    }
+}
+
+std::size_t BMC::lastBoundOfBlock(std::size_t firstBound) const {
+    if (geometricSchedule) {
+        // Blocks [0,0], [1,1], [2,3], [4,7], ...
+        return firstBound <= 1 ? firstBound : 2 * firstBound - 1;
+    }
+    return firstBound + blockSize - 1;
+}
+
 VerificationResult BMC::solve(ChcDirectedGraph const & system) {
     if (isTransitionSystem(system)) {
         auto ts = toTransitionSystem(system, logic);
         return solveTransitionSystem(*ts, system);
     }
-    return VerificationResult(VerificationAnswer::UNKNOWN);
+    return solveLinearGraph(system);
 }
 
 VerificationResult BMC::solveTransitionSystem(TransitionSystem const & system, ChcDirectedGraph const & graph) {
     std::size_t maxLoopUnrollings = std::numeric_limits<std::size_t>::max();
-    PTRef init = system.getInit();
-    PTRef query = system.getQuery();
+    // Init and query occur only positively in the unrolling, no need to eliminate their auxiliary variables
+    PTRef init = system.getInitWithAuxiliaries();
+    PTRef query = system.getQueryWithAuxiliaries();
     PTRef transition = system.getTransition();
 
     SMTConfig config;
@@ -27,32 +68,364 @@ VerificationResult BMC::solveTransitionSystem(TransitionSystem const & system, C
 //    std::cout << "Adding initial states: " << logic.pp(init) << std::endl;
     solver.insertFormula(init);
     { // Check for system with empty initial states
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "bmc.init");
         if (res == s_False) {
             return VerificationResult{VerificationAnswer::SAFE};
         }
     }
 
     TimeMachine tm{logic};
-    for (std::size_t currentUnrolling = 0; currentUnrolling < maxLoopUnrollings; ++currentUnrolling) {
-        PTRef versionedQuery = tm.sendFlaThroughTime(query, currentUnrolling);
-//        std::cout << "Adding query: " << logic.pp(versionedQuery) << std::endl;
+    /*
+     * Transitions 0..first-1 are asserted permanently. A block of bounds [first,last] is checked with the formula
+     * Q_first or (T_first and (Q_first+1 or (... (T_last-1 and Q_last)))), which does not require the transitions
+     * beyond the depth of the counterexample. When the block is refuted, its transitions are asserted permanently.
+     */
+    auto checkBlock = [&](std::size_t first, std::size_t last) {
+        PTRef reachesBad = tm.sendFlaThroughTime(query, last);
+        for (std::size_t depth = last; depth-- > first;) {
+            reachesBad = logic.mkOr(tm.sendFlaThroughTime(query, depth),
+                                    logic.mkAnd(tm.sendFlaThroughTime(transition, depth), reachesBad));
+        }
+        solver.push();
+        solver.insertFormula(reachesBad);
+        auto res = QueryDump::check(solver, "bmc.unrolling");
+        solver.pop();
+        if (res == s_False) {
+            for (std::size_t depth = first; depth <= last; ++depth) {
+                solver.insertFormula(tm.sendFlaThroughTime(transition, depth));
+            }
+        } else if (res != s_True) {
+            throw std::logic_error("Error in the SMT solver");
+        }
+        return res == s_True;
+    };
+
+    std::size_t first = 0;
+    while (first < maxLoopUnrollings) {
+        std::size_t last = lastBoundOfBlock(first);
+        if (not checkBlock(first, last)) {
+            if (verbosity > 1) {
+                std::cout << "; BMC: No path of length " << (first == last ? "" : "up to ") << last << " found!" << std::endl;
+            }
+            GOLEM_PROGRESS("bmc", last, std::nullopt)
+            first = last + 1;
+            continue;
+        }
+        // Binary search for the shortest counterexample in the block; the lower part is refuted if it is unsatisfiable
+        while (first < last) {
+            std::size_t middle = first + (last - first) / 2;
+            if (checkBlock(first, middle)) {
+                last = middle;
+            } else {
+                first = middle + 1;
+            }
+        }
+        if (verbosity > 0) {
+            std::cout << "; BMC: Bug found in depth: " << first << std::endl;
+        }
+        return VerificationResult(VerificationAnswer::UNSAFE, InvalidityWitness::fromTransitionSystem(graph, first));
+    }
+    return VerificationResult(VerificationAnswer::UNKNOWN);
+}
+
+/*
+ * Unrolling of a general linear CHC graph.
+ *
+ * Every step of the unrolling has its own copy of the predicate variables and a Boolean selector for each location
+ * and each edge. An edge selected at step i implies the edge's label (versioned to step i) and the selector of its
+ * source location at step i; a location selected at step i+1 requires one of its incoming edges to be selected at
+ * step i. Only the entry location is selected at step 0.
+ * An error path of length n exists iff the exit location can be selected at step n.
+ */
+VerificationResult BMC::solveLinearGraph(ChcDirectedGraph const & graph) {
+    std::size_t maxSteps = std::numeric_limits<std::size_t>::max();
+    auto adjacency = AdjacencyListsGraphRepresentation::from(graph);
+    auto vertices = graph.getVertices();
+    if (std::find(vertices.begin(), vertices.end(), graph.getExit()) == vertices.end()) {
+        return VerificationResult(VerificationAnswer::UNKNOWN);
+    }
+    std::vector<EId> edges;
+    graph.forEachEdge([&](auto const & edge) { edges.push_back(edge.id); });
+
+    auto locationSelector = [&](SymRef vertex, std::size_t step) {
+        std::string name = "bmc_loc_" + std::to_string(vertex.x) + "_" + std::to_string(step);
+        return logic.mkBoolVar(name.c_str());
+    };
+    auto edgeSelector = [&](EId edge, std::size_t step) {
+        std::string name = "bmc_edge_" + std::to_string(edge.id) + "_" + std::to_string(step);
+        return logic.mkBoolVar(name.c_str());
+    };
+
+    SMTConfig config;
+    const char * msg = "ok";
+    config.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
+    MainSolver solver(logic, config, "BMC");
+    for (SymRef vertex : vertices) {
+        PTRef selector = locationSelector(vertex, 0);
+        solver.insertFormula(vertex == graph.getEntry() ? selector : logic.mkNot(selector));
+    }
+
+    TimeMachine tm{logic};
+    for (std::size_t step = 0; step < maxSteps; ++step) {
+        // Edges taken from step to step + 1
+        for (EId edge : edges) {
+            PTRef label = tm.sendFlaThroughTime(graph.getEdgeLabel(edge), step);
+            PTRef source = locationSelector(graph.getSource(edge), step);
+            solver.insertFormula(logic.mkImpl(edgeSelector(edge, step), logic.mkAnd(source, label)));
+        }
+        for (SymRef vertex : vertices) {
+            vec<PTRef> incoming;
+            for (EId edge : adjacency.getIncomingEdgesFor(vertex)) {
+                incoming.push(edgeSelector(edge, step));
+            }
+            solver.insertFormula(logic.mkImpl(locationSelector(vertex, step + 1), logic.mkOr(std::move(incoming))));
+        }
+
+        std::size_t const pathLength = step + 1;
         solver.push();
-        solver.insertFormula(versionedQuery);
-        auto res = solver.check();
+        solver.insertFormula(locationSelector(graph.getExit(), pathLength));
+        auto res = QueryDump::check(solver, "bmc.linear");
         if (res == s_True) {
             if (verbosity > 0) {
-                std::cout << "; BMC: Bug found in depth: " << currentUnrolling << std::endl;
+                std::cout << "; BMC: Bug found in depth: " << pathLength << std::endl;
+            }
+            auto model = solver.getModel();
+            std::vector<EId> pathEdges;
+            SymRef current = graph.getExit();
+            for (std::size_t i = pathLength; i-- > 0;) {
+                auto const & incoming = adjacency.getIncomingEdgesFor(current);
+                auto it = std::find_if(incoming.begin(), incoming.end(), [&](EId edge) {
+                    return model->evaluate(edgeSelector(edge, i)) == logic.getTerm_true();
+                });
+                assert(it != incoming.end());
+                pathEdges.push_back(*it);
+                current = graph.getSource(*it);
             }
-            return VerificationResult(VerificationAnswer::UNSAFE, InvalidityWitness::fromTransitionSystem(graph, currentUnrolling));
+            assert(current == graph.getEntry());
+            std::reverse(pathEdges.begin(), pathEdges.end());
+            ErrorPath errorPath(std::move(pathEdges));
+            return VerificationResult(VerificationAnswer::UNSAFE, InvalidityWitness::fromErrorPath(errorPath, graph));
+        }
+        if (res != s_False) {
+            throw std::logic_error("BMC: Solver could not decide a query!");
         }
         if (verbosity > 1) {
-            std::cout << "; BMC: No path of length " << currentUnrolling << " found!" << std::endl;
+            std::cout << "; BMC: No path of length " << pathLength << " found!" << std::endl;
         }
+        GOLEM_PROGRESS("bmc", pathLength, std::nullopt)
         solver.pop();
-        PTRef versionedTransition = tm.sendFlaThroughTime(transition, currentUnrolling);
-//        std::cout << "Adding transition: " << logic.pp(versionedTransition) << std::endl;
-        solver.insertFormula(versionedTransition);
+    }
+    return VerificationResult(VerificationAnswer::UNKNOWN);
+}
+
+namespace {
+/*
+ * Unrolling of a nonlinear CHC graph into derivations of increasing height.
+ *
+ * Layer h contains one slot for each predicate, i.e., a Boolean selector saying the slot holds a derived fact and
+ * a copy of the predicate's variables. A fact in layer h is derived by one of the incoming edges, and each premise
+ * of the edge is taken from a slot of the source predicate in any lower layer. Sub-derivations are thus shared as a
+ * DAG instead of being copied for every position in the derivation tree; every derivation tree of height h fits
+ * into h layers as long as it needs at most one distinct fact per predicate and height, and any derivation with n
+ * distinct facts fits into n layers.
+ */
+class TreeUnrolling {
+    Logic & logic;
+    ChcDirectedHyperGraph const & graph;
+    ChcDirectedHyperGraph::VertexInstances vertexInstances;
+    AdjacencyListsGraphRepresentation adjacency;
+    std::vector<SymRef> vertices;
+    SMTConfig config;
+    std::unique_ptr<MainSolver> solver;
+    std::size_t height = 0;
+
+public:
+    TreeUnrolling(Logic & logic, ChcDirectedHyperGraph const & graph) :
+        logic(logic), graph(graph), vertexInstances(graph), adjacency(AdjacencyListsGraphRepresentation::from(graph)) {
+        for (SymRef vertex : graph.getVertices()) {
+            if (vertex != graph.getEntry()) { vertices.push_back(vertex); }
+        }
+        const char * msg = "ok";
+        config.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
+        solver = std::make_unique<MainSolver>(logic, config, "BMC-tree");
+    }
+
+    std::size_t getHeight() const { return height; }
+
+    void addLayer();
+
+    // Checks if the query is derivable in the last layer; on success returns the derivation
+    std::optional<InvalidityWitness::Derivation> checkQuery();
+
+private:
+    PTRef derivedSelector(SymRef vertex, std::size_t layer) const {
+        std::string name = "bmc_derived_" + std::to_string(vertex.x) + "_" + std::to_string(layer);
+        return logic.mkBoolVar(name.c_str());
+    }
+
+    PTRef edgeSelector(EId edge, std::size_t layer) const {
+        std::string name = "bmc_edge_" + std::to_string(edge.id) + "_" + std::to_string(layer);
+        return logic.mkBoolVar(name.c_str());
+    }
+
+    PTRef premiseSelector(EId edge, std::size_t layer, std::size_t premise, std::size_t premiseLayer) const {
+        std::string name = "bmc_premise_" + std::to_string(edge.id) + "_" + std::to_string(layer) + "_"
+            + std::to_string(premise) + "_" + std::to_string(premiseLayer);
+        return logic.mkBoolVar(name.c_str());
+    }
+
+    PTRef copyOf(PTRef var, std::string const & prefix) const {
+        std::string name = prefix + logic.getSymName(var);
+        return logic.mkVar(logic.getSortRef(var), name.c_str());
+    }
+
+    std::vector<PTRef> slotVars(SymRef vertex, std::size_t layer) const {
+        auto vars = TermUtils(logic).predicateArgsInOrder(graph.getNextStateVersion(vertex));
+        std::string prefix = "bmc::" + std::to_string(layer) + "::";
+        std::transform(vars.begin(), vars.end(), vars.begin(), [&](PTRef var) { return copyOf(var, prefix); });
+        return vars;
+    }
+
+    std::size_t buildDerivation(SymRef vertex, std::size_t layer, Model & model, InvalidityWitness::Derivation & derivation,
+                                std::map<std::pair<uint32_t, std::size_t>, std::size_t> & done) const;
+};
+
+void TreeUnrolling::addLayer() {
+    std::size_t const layer = ++height;
+    TermUtils utils(logic);
+    for (SymRef vertex : vertices) {
+        auto const & incoming = adjacency.getIncomingEdgesFor(vertex);
+        auto targetVars = utils.predicateArgsInOrder(graph.getNextStateVersion(vertex));
+        auto targetSlot = slotVars(vertex, layer);
+        vec<PTRef> edgeSelectors;
+        for (EId edge : incoming) {
+            std::string prefix = "bmc::" + std::to_string(layer) + "::" + std::to_string(edge.id) + "::";
+            TermUtils::substitutions_map subst;
+            for (std::size_t i = 0; i < targetVars.size(); ++i) {
+                subst.insert({targetVars[i], targetSlot[i]});
+            }
+            auto renamed = [&](PTRef var) {
+                auto it = subst.find(var);
+                if (it != subst.end()) { return it->second; }
+                PTRef copy = copyOf(var, prefix);
+                subst.insert({var, copy});
+                return copy;
+            };
+            PTRef label = graph.getEdgeLabel(edge);
+            for (PTRef var : utils.getVars(label)) {
+                renamed(var);
+            }
+            vec<PTRef> components;
+            auto const & sources = graph.getSources(edge);
+            for (std::size_t premise = 0; premise < sources.size(); ++premise) {
+                SymRef source = sources[premise];
+                if (source == graph.getEntry()) { continue; }
+                auto sourceVars = utils.predicateArgsInOrder(graph.getStateVersion(source, vertexInstances.getInstanceNumber(edge, premise)));
+                vec<PTRef> choices;
+                for (std::size_t premiseLayer = 1; premiseLayer < layer; ++premiseLayer) {
+                    auto premiseSlot = slotVars(source, premiseLayer);
+                    vec<PTRef> premiseConstraints;
+                    premiseConstraints.push(derivedSelector(source, premiseLayer));
+                    for (std::size_t i = 0; i < sourceVars.size(); ++i) {
+                        premiseConstraints.push(logic.mkEq(renamed(sourceVars[i]), premiseSlot[i]));
+                    }
+                    PTRef choice = premiseSelector(edge, layer, premise, premiseLayer);
+                    solver->insertFormula(logic.mkImpl(choice, logic.mkAnd(std::move(premiseConstraints))));
+                    choices.push(choice);
+                }
+                components.push(logic.mkOr(std::move(choices)));
+            }
+            components.push(utils.varSubstitute(label, subst));
+            PTRef selector = edgeSelector(edge, layer);
+            solver->insertFormula(logic.mkImpl(selector, logic.mkAnd(std::move(components))));
+            edgeSelectors.push(selector);
+        }
+        solver->insertFormula(logic.mkImpl(derivedSelector(vertex, layer), logic.mkOr(std::move(edgeSelectors))));
+    }
+}
+
+std::optional<InvalidityWitness::Derivation> TreeUnrolling::checkQuery() {
+    solver->push();
+    solver->insertFormula(derivedSelector(graph.getExit(), height));
+    auto res = QueryDump::check(*solver, "bmc.tree");
+    if (res == s_False) {
+        solver->pop();
+        return std::nullopt;
+    }
+    if (res != s_True) {
+        throw std::logic_error("BMC: Solver could not decide a query!");
+    }
+    auto model = solver->getModel();
+    solver->pop();
+    InvalidityWitness::Derivation derivation;
+    derivation.addDerivationStep({.index = 0, .premises = {}, .derivedFact = logic.getTerm_true(), .clauseId = {static_cast<std::size_t>(-1)}});
+    std::map<std::pair<uint32_t, std::size_t>, std::size_t> done;
+    buildDerivation(graph.getExit(), height, *model, derivation, done);
+    return derivation;
+}
+
+std::size_t TreeUnrolling::buildDerivation(SymRef vertex, std::size_t layer, Model & model,
+                                           InvalidityWitness::Derivation & derivation,
+                                           std::map<std::pair<uint32_t, std::size_t>, std::size_t> & done) const {
+    auto it = done.find({vertex.x, layer});
+    if (it != done.end()) { return it->second; }
+    auto isTrue = [&](PTRef selector) { return model.evaluate(selector) == logic.getTerm_true(); };
+    auto const & incoming = adjacency.getIncomingEdgesFor(vertex);
+    auto edgeIt = std::find_if(incoming.begin(), incoming.end(), [&](EId edge) { return isTrue(edgeSelector(edge, layer)); });
+    if (edgeIt == incoming.end()) { throw std::logic_error("BMC: Error in reconstructing derivation"); }
+    EId edge = *edgeIt;
+    std::vector<std::size_t> premises;
+    auto const & sources = graph.getSources(edge);
+    for (std::size_t premise = 0; premise < sources.size(); ++premise) {
+        SymRef source = sources[premise];
+        if (source == graph.getEntry()) {
+            premises.push_back(0);
+            continue;
+        }
+        std::size_t premiseLayer = 1;
+        while (premiseLayer < layer and not isTrue(premiseSelector(edge, layer, premise, premiseLayer))) {
+            ++premiseLayer;
+        }
+        if (premiseLayer == layer) { throw std::logic_error("BMC: Error in reconstructing derivation"); }
+        premises.push_back(buildDerivation(source, premiseLayer, model, derivation, done));
+    }
+    PTRef fact = logic.getTerm_false();
+    if (vertex != graph.getExit()) {
+        vec<PTRef> values;
+        for (PTRef var : slotVars(vertex, layer)) {
+            values.push(model.evaluate(var));
+        }
+        fact = logic.insertTerm(vertex, std::move(values));
+    }
+    std::size_t index = derivation.size();
+    derivation.addDerivationStep({.index = index, .premises = std::move(premises), .derivedFact = fact, .clauseId = edge});
+    done.insert({{vertex.x, layer}, index});
+    return index;
+}
+}
+
+VerificationResult BMC::solveNonlinear(ChcDirectedHyperGraph const & graph) {
+    std::size_t maxHeight = std::numeric_limits<std::size_t>::max();
+    auto vertices = graph.getVertices();
+    if (std::find(vertices.begin(), vertices.end(), graph.getExit()) == vertices.end()) {
+        return VerificationResult(VerificationAnswer::UNKNOWN);
+    }
+    TreeUnrolling unrolling(logic, graph);
+    while (unrolling.getHeight() < maxHeight) {
+        unrolling.addLayer();
+        auto derivation = unrolling.checkQuery();
+        if (derivation.has_value()) {
+            if (verbosity > 0) {
+                std::cout << "; BMC: Bug found with derivation of height: " << unrolling.getHeight() << std::endl;
+            }
+            InvalidityWitness witness;
+            witness.setDerivation(std::move(derivation.value()));
+            return VerificationResult(VerificationAnswer::UNSAFE, std::move(witness));
+        }
+        if (verbosity > 1) {
+            std::cout << "; BMC: No derivation of height " << unrolling.getHeight() << " found!" << std::endl;
+        }
+        GOLEM_PROGRESS("bmc", unrolling.getHeight(), std::nullopt)
     }
     return VerificationResult(VerificationAnswer::UNKNOWN);
 }
@@ -14,26 +14,30 @@ class BMC : public Engine {
     Logic & logic;
 //    Options const & options;
     int verbosity = 0;
+    // Schedule of bounds for transition systems: blocks of consecutive bounds are checked with a single query
+    bool geometricSchedule = false;
+    std::size_t blockSize = 1;
 public:
 
-    BMC(Logic & logic, Options const & options) : logic(logic) {
-        if (options.hasOption(Options::VERBOSE)) {
-            verbosity = std::stoi(options.getOption(Options::VERBOSE));
-        }
-    }
+    BMC(Logic & logic, Options const & options);
 
     virtual VerificationResult solve(ChcDirectedHyperGraph & graph) override {
         if (graph.isNormalGraph()) {
             auto normalGraph = graph.toNormalGraph();
             return solve(*normalGraph);
         }
-        return VerificationResult(VerificationAnswer::UNKNOWN);
+        return solveNonlinear(graph);
     }
 
     VerificationResult solve(ChcDirectedGraph const & system);
 
+    VerificationResult solveNonlinear(ChcDirectedHyperGraph const & graph);
+
 private:
     VerificationResult solveTransitionSystem(TransitionSystem const & system, ChcDirectedGraph const & graph);
+    VerificationResult solveLinearGraph(ChcDirectedGraph const & graph);
+
+    std::size_t lastBoundOfBlock(std::size_t firstBound) const;
 };
 
 
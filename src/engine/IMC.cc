@@ -5,12 +5,20 @@
  */
 
 #include "IMC.h"
+#include "Progress.h"
+#include "QueryDump.h"
 #include "TermUtils.h"
 #include "TransformationUtils.h"
 
+const std::string IMC::ORIGINAL = "imc";
+const std::string IMC::INTERPOLATION_SEQUENCES = "ismc";
+
 VerificationResult IMC::solve(ChcDirectedGraph const & system) {
     if (isTransitionSystem(system)) {
         auto ts = toTransitionSystem(system, logic);
+        if (useInterpolationSequences) {
+            return solveWithInterpolationSequences(*ts, system);
+        }
         return solveTransitionSystem(*ts, system);
     }
     return VerificationResult(VerificationAnswer::UNKNOWN);
@@ -32,8 +40,8 @@ VerificationResult IMC::solveTransitionSystem(TransitionSystem const & system, C
     PTRef versionedQuery = tm.sendFlaThroughTime(query, 0);
     initSolver.insertFormula(versionedQuery);
     //if I /\ F is Satisfiable, return true
-    if (initSolver.check() == s_True) {
-        VerificationResult{VerificationAnswer::UNSAFE, InvalidityWitness::fromTransitionSystem(graph, 0)};
+    if (QueryDump::check(initSolver, "imc.init") == s_True) {
+        return VerificationResult{VerificationAnswer::UNSAFE, InvalidityWitness::fromTransitionSystem(graph, 0)};
     }
     for (uint32_t k = 1; k < maxLoopUnrollings; ++k) {
         InterpolantResult res = finiteRun(init, transition, query, k);
@@ -43,6 +51,97 @@ VerificationResult IMC::solveTransitionSystem(TransitionSystem const & system, C
         if (res.result == l_False) {
             return VerificationResult{VerificationAnswer::SAFE, ValidityWitness::fromTransitionSystem(logic, graph, system, res.interpolant)};
         }
+        // The first iteration of the finite run is plain BMC of depth k
+        GOLEM_PROGRESS("imc", k, std::nullopt)
+    }
+    return VerificationResult(VerificationAnswer::UNKNOWN);
+}
+
+/*
+ * Interpolation-sequence based model checking (ISMC).
+ *
+ * A single incremental BMC unrolling Init(x0) /\ Tr(x0,x1) /\ ... /\ Tr(x_{k-1},x_k) /\ Query(x_k) is kept for all
+ * bounds; only the query is pushed and popped. Every inserted formula is its own partition, so after an unsatisfiable
+ * check the whole interpolation sequence I_1, ..., I_k is extracted from the same proof.
+ * Interpolants for the same depth j are conjoined across bounds into over-approximations R_j of the states reachable
+ * in exactly j steps. If R_j is contained in Init \/ R_1 \/ ... \/ R_{j-1}, this disjunction is a safe inductive
+ * invariant.
+ */
+VerificationResult IMC::solveWithInterpolationSequences(TransitionSystem const & system, ChcDirectedGraph const & graph) {
+    std::size_t maxLoopUnrollings = std::numeric_limits<std::size_t>::max();
+    PTRef init = system.getInit();
+    PTRef query = system.getQuery();
+    PTRef transition = system.getTransition();
+
+    SMTConfig config;
+    const char * msg = "ok";
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    config.setSimplifyInterpolant(4);
+    TimeMachine tm{logic};
+    MainSolver solver(logic, config, "ISMC");
+    // Partitions are numbered by the order of insertion, including formulas that have been popped
+    unsigned formulasInserted = 0;
+    ipartitions_t prefixMask = 0;
+    solver.insertFormula(init);
+    opensmt::setbit(prefixMask, formulasInserted++);
+    solver.push();
+    solver.insertFormula(query);
+    ++formulasInserted;
+    if (QueryDump::check(solver, "imc.init") == s_True) {
+        return VerificationResult{VerificationAnswer::UNSAFE, InvalidityWitness::fromTransitionSystem(graph, 0)};
+    }
+    solver.pop();
+
+    std::vector<unsigned> transitionPartitions;
+    std::vector<PTRef> reachable; // reachable[j-1] over-approximates states reachable in exactly j steps
+    for (std::size_t k = 1; k < maxLoopUnrollings; ++k) {
+        solver.insertFormula(tm.sendFlaThroughTime(transition, k - 1));
+        transitionPartitions.push_back(formulasInserted++);
+        solver.push();
+        solver.insertFormula(tm.sendFlaThroughTime(query, k));
+        ++formulasInserted;
+        auto res = QueryDump::check(solver, "imc.unrolling");
+        if (res == s_True) {
+            if (verbosity > 0) {
+                std::cout << "; ISMC: Bug found in depth: " << k << std::endl;
+            }
+            return VerificationResult{VerificationAnswer::UNSAFE, InvalidityWitness::fromTransitionSystem(graph, k)};
+        }
+        if (res != s_False) {
+            throw std::logic_error("ISMC: Solver could not decide a query!");
+        }
+        auto itpContext = solver.getInterpolationContext();
+        ipartitions_t mask = prefixMask;
+        for (std::size_t j = 1; j <= k; ++j) {
+            opensmt::setbit(mask, transitionPartitions[j - 1]);
+            vec<PTRef> itps;
+            itpContext->getSingleInterpolant(itps, mask);
+            assert(itps.size() == 1);
+            PTRef itp = tm.sendFlaThroughTime(itps[0], -static_cast<int>(j));
+            if (j <= reachable.size()) {
+                reachable[j - 1] = logic.mkAnd(reachable[j - 1], itp);
+            } else {
+                reachable.push_back(itp);
+            }
+        }
+        solver.pop();
+        if (verbosity > 1) {
+            std::cout << "; ISMC: No path of length " << k << " found!" << std::endl;
+        }
+        GOLEM_PROGRESS("ismc", k, reachable.size())
+        // Fixed point check
+        vec<PTRef> reachedSoFar;
+        reachedSoFar.push(init);
+        for (std::size_t j = 1; j <= k; ++j) {
+            PTRef previous = logic.mkOr(reachedSoFar);
+            if (checkItp(reachable[j - 1], previous) == s_False) {
+                if (verbosity > 0) {
+                    std::cout << "; ISMC: Fixed point found at depth " << j << " with bound " << k << std::endl;
+                }
+                return VerificationResult{VerificationAnswer::SAFE, ValidityWitness::fromTransitionSystem(logic, graph, system, previous)};
+            }
+            reachedSoFar.push(reachable[j - 1]);
+        }
     }
     return VerificationResult(VerificationAnswer::UNKNOWN);
 }
@@ -69,7 +168,7 @@ IMC::InterpolantResult IMC::finiteRun(PTRef init, PTRef transition, PTRef query,
         }
         solver.insertFormula(B);
         // Run SAT on A U B.
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "imc.finite-run");
         // if A U B is satisfiable
         if (res == s_True) {
             if (movingInit == init) {
@@ -112,5 +211,5 @@ sstat IMC::checkItp(PTRef itp, PTRef itpsOld) {
     PTRef cmp = logic.mkAnd(itp, logic.mkNot(itpsOld));
     MainSolver itpSolver(logic, itp_config, "Interpolant");
     itpSolver.insertFormula(cmp);
-    return itpSolver.check();
+    return QueryDump::check(itpSolver, "imc.fixed-point");
 }
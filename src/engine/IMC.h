@@ -14,6 +14,7 @@ class IMC : public Engine {
     Logic & logic;
 //    Options const & options;
     int verbosity = 0;
+    bool useInterpolationSequences = false;
 public:
     struct InterpolantResult{
         lbool result;
@@ -25,8 +26,14 @@ public:
         if (options.hasOption(Options::VERBOSE)) {
             verbosity = std::stoi(options.getOption(Options::VERBOSE));
         }
+        if (options.hasOption(Options::ENGINE)) {
+            useInterpolationSequences = options.getOption(Options::ENGINE) == INTERPOLATION_SEQUENCES;
+        }
     }
 
+    static const std::string ORIGINAL;
+    static const std::string INTERPOLATION_SEQUENCES;
+
     virtual VerificationResult solve(ChcDirectedHyperGraph & graph) override {
         if (graph.isNormalGraph()) {
             auto normalGraph = graph.toNormalGraph();
@@ -40,6 +47,7 @@ public:
 private:
     InterpolantResult finiteRun(PTRef init, PTRef transition, PTRef query, int k);
     VerificationResult solveTransitionSystem(TransitionSystem const & system, ChcDirectedGraph const & graph);
+    VerificationResult solveWithInterpolationSequences(TransitionSystem const & system, ChcDirectedGraph const & graph);
     PTRef lastIterationInterpolant(MainSolver & solver, ipartitions_t const & mask);
     sstat checkItp(PTRef itp, PTRef itpsOld);
 };
@@ -7,10 +7,15 @@
 #include "Kind.h"
 
 #include "QuantifierElimination.h"
+#include "Progress.h"
+#include "QueryDump.h"
 #include "TermUtils.h"
 #include "transformers/BasicTransformationPipelines.h"
 #include "TransformationUtils.h"
 
+#include <algorithm>
+#include <memory>
+
 VerificationResult Kind::solve(ChcDirectedHyperGraph & graph) {
     auto pipeline = Transformations::towardsTransitionSystems();
     auto transformationResult = pipeline.transform(std::make_unique<ChcDirectedHyperGraph>(graph));
@@ -32,6 +37,169 @@ VerificationResult Kind::solve(ChcDirectedGraph const & system) {
     return VerificationResult(VerificationAnswer::UNKNOWN);
 }
 
+namespace {
+// Octagon candidates are generated only for systems with few numeric state variables
+constexpr std::size_t octagonVariableLimit = 8;
+
+/*
+ * Keeps the auxiliary invariants discovered so far and checks new candidates against them.
+ * A set of candidates is checked Houdini-style: candidates not implied by the initial states are dropped, then
+ * candidates that are not preserved by the transition relation (assuming all candidates and known invariants)
+ * are dropped until the remaining set is inductive.
+ * Both checks use solvers that live as long as this object: the initial states, the transition relation and the
+ * known invariants are asserted once, the candidates of one round are pushed on top of them.
+ */
+class AuxiliaryInvariants {
+    Logic & logic;
+    TransitionSystem const & system;
+    std::vector<PTRef> invariants;
+    SMTConfig initConfig;
+    SMTConfig stepConfig;
+    // Created on first use
+    std::unique_ptr<MainSolver> initSolver;
+    std::unique_ptr<MainSolver> stepSolver;
+
+    sstat checkUnder(MainSolver & solver, PTRef fla) {
+        solver.push();
+        solver.insertFormula(fla);
+        auto res = QueryDump::check(solver, "kind.aux-invariants");
+        solver.pop();
+        if (res == s_Undef) {
+            throw std::logic_error("KIND: Solver could not decide a query!");
+        }
+        return res;
+    }
+
+public:
+    AuxiliaryInvariants(Logic & logic, TransitionSystem const & system) : logic(logic), system(system) {}
+
+    PTRef getInvariant() const {
+        vec<PTRef> args;
+        for (PTRef invariant : invariants) {
+            args.push(invariant);
+        }
+        return logic.mkAnd(std::move(args));
+    }
+
+    // Returns the candidates that have been added as new invariants
+    std::vector<PTRef> strengthenWith(std::vector<PTRef> candidates) {
+        std::unordered_set<PTRef, PTRefHash> seen(invariants.begin(), invariants.end());
+        seen.insert(logic.getTerm_true());
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](PTRef candidate) {
+            return not seen.insert(candidate).second;
+        }), candidates.end());
+        if (candidates.empty()) { return {}; }
+        if (not initSolver) {
+            initSolver = std::make_unique<MainSolver>(logic, initConfig, "KIND-aux-init");
+            initSolver->insertFormula(system.getInit());
+            stepSolver = std::make_unique<MainSolver>(logic, stepConfig, "KIND-aux-step");
+            stepSolver->insertFormula(system.getTransition());
+        }
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](PTRef candidate) {
+            return checkUnder(*initSolver, logic.mkNot(candidate)) != s_False;
+        }), candidates.end());
+        TimeMachine tm{logic};
+        bool changed = true;
+        while (changed and not candidates.empty()) {
+            stepSolver->push();
+            for (PTRef candidate : candidates) {
+                stepSolver->insertFormula(candidate);
+            }
+            auto it = std::remove_if(candidates.begin(), candidates.end(), [&](PTRef candidate) {
+                return checkUnder(*stepSolver, logic.mkNot(tm.sendFlaThroughTime(candidate, 1))) != s_False;
+            });
+            stepSolver->pop();
+            changed = it != candidates.end();
+            candidates.erase(it, candidates.end());
+        }
+        for (PTRef invariant : candidates) {
+            stepSolver->insertFormula(invariant);
+        }
+        invariants.insert(invariants.end(), candidates.begin(), candidates.end());
+        return candidates;
+    }
+};
+
+// Interval and octagon constraints with bounds taken from one initial state
+std::vector<PTRef> templateCandidates(Logic & logic, TransitionSystem const & system) {
+    auto * arithLogic = dynamic_cast<ArithLogic *>(&logic);
+    if (not arithLogic) { return {}; }
+    SMTConfig config;
+    const char * msg = "ok";
+    config.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
+    MainSolver solver(logic, config, "KIND-templates");
+    solver.insertFormula(system.getInit());
+    if (QueryDump::check(solver, "kind.template-init") != s_True) { return {}; }
+    auto model = solver.getModel();
+    std::vector<PTRef> vars;
+    for (PTRef var : system.getStateVars()) {
+        if (arithLogic->isNumVar(var)) {
+            vars.push_back(var);
+        }
+    }
+    std::vector<PTRef> candidates;
+    auto addBounds = [&](PTRef term) {
+        PTRef value = model->evaluate(term);
+        candidates.push_back(arithLogic->mkLeq(term, value));
+        candidates.push_back(arithLogic->mkGeq(term, value));
+    };
+    for (PTRef var : vars) {
+        addBounds(var);
+    }
+    if (vars.size() <= octagonVariableLimit) {
+        for (std::size_t i = 0; i < vars.size(); ++i) {
+            for (std::size_t j = i + 1; j < vars.size(); ++j) {
+                addBounds(arithLogic->mkMinus(vars[i], vars[j]));
+                addBounds(arithLogic->mkPlus(vars[i], vars[j]));
+            }
+        }
+    }
+    return candidates;
+}
+
+/*
+ * Conjuncts of an interpolant between Init(x0) and Tr^k(x0,xk) /\ Query(xk), taken from the base-case solver right
+ * after its check at bound k was unsatisfiable; the initial states are its first partition.
+ */
+std::vector<PTRef> baseCaseCandidates(Logic & logic, MainSolver & solver) {
+    ipartitions_t mask = 0;
+    opensmt::setbit(mask, 0);
+    vec<PTRef> itps;
+    solver.getInterpolationContext()->getSingleInterpolant(itps, mask);
+    assert(itps.size() == 1);
+    auto conjuncts = TermUtils(logic).getTopLevelConjuncts(itps[0]);
+    return std::vector<PTRef>(conjuncts.begin(), conjuncts.end());
+}
+
+/*
+ * Adds constraints forcing distinct states for all pairs of states on the unrolling that are equal in the current model.
+ * Returns false if there is no such pair.
+ */
+bool addSimplePathConstraints(MainSolver & solver, Logic & logic, std::vector<PTRef> const & stateVars, std::size_t stateCount) {
+    auto model = solver.getModel();
+    TimeMachine tm{logic};
+    std::vector<std::vector<PTRef>> states(stateCount);
+    for (std::size_t i = 0; i < stateCount; ++i) {
+        for (PTRef var : stateVars) {
+            states[i].push_back(model->evaluate(tm.sendVarThroughTime(var, static_cast<int>(i))));
+        }
+    }
+    bool added = false;
+    for (std::size_t i = 0; i < stateCount; ++i) {
+        for (std::size_t j = i + 1; j < stateCount; ++j) {
+            if (states[i] != states[j]) { continue; }
+            vec<PTRef> differences;
+            for (PTRef var : stateVars) {
+                differences.push(logic.mkNot(logic.mkEq(tm.sendVarThroughTime(var, static_cast<int>(i)), tm.sendVarThroughTime(var, static_cast<int>(j)))));
+            }
+            solver.insertFormula(logic.mkOr(std::move(differences)));
+            added = true;
+        }
+    }
+    return added;
+}
+}
+
 VerificationResult Kind::solveTransitionSystem(TransitionSystem const & system, ChcDirectedGraph const & graph) {
     std::size_t maxK = std::numeric_limits<std::size_t>::max();
     PTRef init = system.getInit();
@@ -48,30 +216,65 @@ VerificationResult Kind::solveTransitionSystem(TransitionSystem const & system,
     SMTConfig configBase;
     SMTConfig configStepForward;
     SMTConfig configStepBackward;
+    if (auxiliaryInvariants) {
+        // Candidate invariants are interpolants of the unsatisfiable base cases
+        const char * msg = "ok";
+        configBase.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+        configBase.setSimplifyInterpolant(4);
+    }
+    if (simplePath) {
+        const char * msg = "ok";
+        configStepForward.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
+        configStepBackward.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
+    }
     MainSolver solverBase(logic, configBase, "KIND-base");
     MainSolver solverStepForward(logic, configStepForward, "KIND-stepForward");
     MainSolver solverStepBackward(logic, configStepBackward, "KIND-stepBackward");
 
     PTRef negQuery = logic.mkNot(query);
     PTRef negInit = logic.mkNot(init);
-    // starting point
-    solverBase.insertFormula(init);
+    // starting point; the base case is a plain unrolling, so it does not need the projected initial and bad states
+    // (the initial states are partition 0 of the base-case solver, see baseCaseCandidates)
+    solverBase.insertFormula(system.getInitWithAuxiliaries());
     solverStepBackward.insertFormula(init);
     solverStepForward.insertFormula(query);
     { // Check for system with empty initial states
-        auto res = solverBase.check();
+        auto res = QueryDump::check(solverBase, "kind.base");
         if (res == s_False) {
             return VerificationResult{VerificationAnswer::SAFE};
         }
     }
 
     TimeMachine tm{logic};
+    // Auxiliary invariants hold in every reachable state, so they can be assumed in every state of the forward step
+    AuxiliaryInvariants invariants(logic, system);
+    std::size_t forwardStates = 1;
+    auto strengthenForwardStep = [&](std::vector<PTRef> const & newInvariants) {
+        for (PTRef invariant : newInvariants) {
+            if (verbosity > 1) {
+                std::cout << "; KIND: Auxiliary invariant found: " << logic.pp(invariant) << std::endl;
+            }
+            for (std::size_t i = 0; i < forwardStates; ++i) {
+                solverStepForward.insertFormula(tm.sendFlaThroughTime(invariant, static_cast<int>(i)));
+            }
+        }
+    };
+    auto checkStep = [&](MainSolver & solver, std::size_t stateCount) {
+        auto res = QueryDump::check(solver, "kind.step");
+        while (simplePath and res == s_True and addSimplePathConstraints(solver, logic, system.getStateVars(), stateCount)) {
+            res = QueryDump::check(solver, "kind.step");
+        }
+        return res;
+    };
+    if (auxiliaryInvariants) {
+        strengthenForwardStep(invariants.strengthenWith(templateCandidates(logic, system)));
+    }
     for (std::size_t k = 0; k < maxK; ++k) {
-        PTRef versionedQuery = tm.sendFlaThroughTime(query, k);
+        PTRef versionedQuery = tm.sendFlaThroughTime(system.getQueryWithAuxiliaries(), k);
         // Base case
         solverBase.push();
         solverBase.insertFormula(versionedQuery);
-        auto res = solverBase.check();
+        auto res = QueryDump::check(solverBase, "kind.base");
         if (res == s_True) {
             if (verbosity > 0) {
                  std::cout << "; KIND: Bug found in depth: " << k << std::endl;
@@ -85,19 +288,23 @@ VerificationResult Kind::solveTransitionSystem(TransitionSystem const & system,
         if (verbosity > 1) {
             std::cout << "; KIND: No path of length " << k << " found!" << std::endl;
         }
+        GOLEM_PROGRESS("kind", k, std::nullopt)
+        if (auxiliaryInvariants and res == s_False) {
+            strengthenForwardStep(invariants.strengthenWith(baseCaseCandidates(logic, solverBase)));
+        }
         solverBase.pop();
         PTRef versionedTransition = tm.sendFlaThroughTime(transition, k);
 //        std::cout << "Adding transition: " << logic.pp(versionedTransition) << std::endl;
         solverBase.insertFormula(versionedTransition);
 
         // step forward
-        res = solverStepForward.check();
+        res = checkStep(solverStepForward, k + 1);
         if (res == s_False) {
             if (verbosity > 0) {
                 std::cout << "; KIND: Found invariant with forward induction, which is " << k << "-inductive" << std::endl;
             }
             if (computeWitness) {
-                return VerificationResult(VerificationAnswer::SAFE, witnessFromForwardInduction(graph, system, k));
+                return VerificationResult(VerificationAnswer::SAFE, witnessFromForwardInduction(graph, system, k, invariants.getInvariant()));
             } else {
                 return VerificationResult(VerificationAnswer::SAFE);
             }
@@ -106,9 +313,11 @@ VerificationResult Kind::solveTransitionSystem(TransitionSystem const & system,
         solverStepForward.push();
         solverStepForward.insertFormula(versionedBackwardTransition);
         solverStepForward.insertFormula(tm.sendFlaThroughTime(negQuery,k+1));
+        solverStepForward.insertFormula(tm.sendFlaThroughTime(invariants.getInvariant(), k+1));
+        ++forwardStates;
 
         // step backward
-        res = solverStepBackward.check();
+        res = checkStep(solverStepBackward, k + 1);
         if (res == s_False) {
             if (verbosity > 0) {
                 std::cout << "; KIND: Found invariant with backward induction, which is " << k << "-inductive" << std::endl;
@@ -126,9 +335,10 @@ VerificationResult Kind::solveTransitionSystem(TransitionSystem const & system,
     return VerificationResult(VerificationAnswer::UNKNOWN);
 }
 
-ValidityWitness Kind::witnessFromForwardInduction(ChcDirectedGraph const & graph,
-                                                  TransitionSystem const & transitionSystem, unsigned long k) const {
-    PTRef kinductiveInvariant = logic.mkNot(transitionSystem.getQuery());
+ValidityWitness Kind::witnessFromForwardInduction(ChcDirectedGraph const & graph, TransitionSystem const & transitionSystem,
+                                                  unsigned long k, PTRef auxiliaryInvariant) const {
+    // The safety property is k-inductive relative to the auxiliary invariant, so their conjunction is k-inductive
+    PTRef kinductiveInvariant = logic.mkAnd(auxiliaryInvariant, logic.mkNot(transitionSystem.getQuery()));
     PTRef inductiveInvariant = kinductiveToInductive(kinductiveInvariant, k, transitionSystem);
     return ValidityWitness::fromTransitionSystem(logic, graph, transitionSystem, inductiveInvariant);
 }
@@ -12,11 +12,23 @@
 #include "Engine.h"
 #include "TransitionSystem.h"
 
+/*
+ * k-induction for transition systems, checking forward and backward induction in parallel with the base case
+ *
+ * Optionally, the induction steps can be strengthened by
+ *  - simple-path constraints: states on the unrolled path are required to be pairwise distinct; the constraints are
+ *    added lazily, only for pairs of states that are equal in a counterexample to induction;
+ *  - auxiliary invariants: interval and octagon candidates from the initial states and conjuncts of interpolants
+ *    from unsatisfiable base cases are checked for inductiveness (Houdini-style) and the surviving ones are added
+ *    to the forward induction step.
+ */
 class Kind : public Engine {
     Logic & logic;
 //    Options const & options;
     int verbosity {0};
     bool computeWitness {false};
+    bool simplePath {false};
+    bool auxiliaryInvariants {false};
 public:
 
     Kind(Logic & logic, Options const & options) : logic(logic) {
@@ -26,6 +38,9 @@ public:
         if (options.hasOption(Options::COMPUTE_WITNESS)) {
             computeWitness = options.getOption(Options::COMPUTE_WITNESS) == "true";
         }
+        // Witness computation relies on plain k-inductiveness, which simple-path constraints do not guarantee
+        simplePath = options.hasOption(Options::KIND_SIMPLE_PATH) and not computeWitness;
+        auxiliaryInvariants = options.hasOption(Options::KIND_AUX_INVARIANTS);
     }
 
     virtual VerificationResult solve(ChcDirectedHyperGraph & graph) override;
@@ -35,8 +50,8 @@ public:
 private:
     VerificationResult solveTransitionSystem(TransitionSystem const & system, ChcDirectedGraph const & graph);
 
-    ValidityWitness witnessFromForwardInduction(ChcDirectedGraph const & graph,
-                                                TransitionSystem const & transitionSystem, unsigned long k) const;
+    ValidityWitness witnessFromForwardInduction(ChcDirectedGraph const & graph, TransitionSystem const & transitionSystem,
+                                                unsigned long k, PTRef auxiliaryInvariant) const;
 
     ValidityWitness witnessFromBackwardInduction(ChcDirectedGraph const & graph,
                                                  TransitionSystem const & transitionSystem, unsigned long k) const;
@@ -6,8 +6,21 @@
 
 #include "Lawi.h"
 
+#include "InterpolationSelection.h"
+#include "Progress.h"
+#include "QueryDump.h"
+#include "SampleStore.h"
+#include "SyntacticImplication.h"
+#include "Tracing.h"
+#include "graph/LargeBlockEncoding.h"
+
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <list>
 #include <optional>
+#include <set>
+#include <unordered_set>
 
 namespace{
 
@@ -56,11 +69,14 @@ private:
     std::map<VId, SymRef> toOriginalLoc;
     std::map<EId, EId> toOriginalEdge;
     std::size_t vertexCount = 0;
+    std::size_t edgeCount = 0;
     VId getNewVertex() { return VId{vertexCount++}; }
 
-	std::vector<Edge> edges;
+    std::unordered_map<std::size_t, Edge> edges;
     std::map<VId, std::vector<EId>> childrenOf;
     std::map<VId, EId> parentOf;
+    // Live vertices of each original location, ordered by creation
+    std::unordered_map<SymRef, std::set<std::size_t>, SymRefHash> verticesOf;
 
 
 public:
@@ -68,8 +84,11 @@ public:
         : graph(graph), graphRepresentation(AdjacencyListsGraphRepresentation::from(graph)) {
         root = getNewVertex();
         toOriginalLoc.insert({root, graph.getEntry()});
+        verticesOf[graph.getEntry()].insert(root.id);
     }
 
+    bool contains(VId vertex) const { return toOriginalLoc.count(vertex) != 0; }
+
     bool isErrorLocation(VId vertex) const { return getOriginalLocation(vertex) == getOriginalErrorLocation(); }
     bool sameLocation(VId v1, VId v2) const { return getOriginalLocation(v1) == getOriginalLocation(v2); }
 
@@ -89,6 +108,11 @@ public:
 
     std::vector<VId> expand(VId vertex);
 
+    // Removes all descendants of the vertex (the vertex becomes a leaf), returns the removed vertices
+    std::vector<VId> removeDescendantsOf(VId vertex);
+    // Removes a leaf together with the edge leading to it
+    void removeLeaf(VId leaf);
+
     // Path goes in the direction from root to leaves
     ArtPath getPathFromInit(VId vertex, Logic & logic) const;
     ArtPath getPath(VId descendant, VId ancestor , Logic & logic) const;
@@ -111,8 +135,8 @@ public:
 private:
     // helpers
     void connect(VId from, VId to, EId originalEdge) {
-        EId eid{edges.size()};
-        edges.push_back(Edge{from, to});
+        EId eid{edgeCount++};
+        edges.insert({eid.id, Edge{from, to}});
         toOriginalEdge.insert({eid, originalEdge});
         auto it = childrenOf.find(from);
         if (it == childrenOf.end()) {
@@ -128,9 +152,22 @@ private:
     VId newVertexFor(SymRef originalLocation) {
         VId nv = getNewVertex();
         toOriginalLoc.insert({nv, originalLocation});
+        verticesOf[originalLocation].insert(nv.id);
         return nv;
     }
 
+    void removeVertex(VId vertex) {
+        auto it = parentOf.find(vertex);
+        if (it != parentOf.end()) {
+            edges.erase(it->second.id);
+            toOriginalEdge.erase(it->second);
+            parentOf.erase(it);
+        }
+        childrenOf.erase(vertex);
+        verticesOf[getOriginalLocation(vertex)].erase(vertex.id);
+        toOriginalLoc.erase(vertex);
+    }
+
 };
 
 class CoveringRelation {
@@ -162,28 +199,69 @@ public:
 
     void vertexStrengthened(VId vertex);
 
+    // Forgets all elements that mention any of the given (removed) vertices
+    void verticesRemoved(std::vector<VId> const & vertices);
+
 private:
 };
 
 class LabelingFunction {
-    std::map<VId, PTRef> labels;
+    std::unordered_map<std::size_t, PTRef> labels;
 public:
     PTRef getLabel(VId vertex) const {
-        assert(labels.count(vertex) != 0);
-        return labels.at(vertex);
+        assert(labels.count(vertex.id) != 0);
+        return labels.at(vertex.id);
     }
 
     void addLabel(VId vertex, PTRef label) {
-        assert(labels.count(vertex) == 0);
-        labels.insert({vertex, label});
+        assert(labels.count(vertex.id) == 0);
+        labels.insert({vertex.id, label});
     }
 
     void replaceLabel(VId vertex, PTRef label) {
-        auto it = labels.find(vertex);
+        auto it = labels.find(vertex.id);
         assert(it != labels.end());
         it->second = label;
 
     }
+
+    void removeLabel(VId vertex) {
+        labels.erase(vertex.id);
+    }
+};
+
+/*
+ * Leaves of the ART waiting to be processed.
+ * Newer leaves have priority; insertion and removal are constant time.
+ */
+class LeafSet {
+    std::list<VId> order;
+    std::unordered_map<std::size_t, std::list<VId>::iterator> positions;
+public:
+    bool contains(VId leaf) const { return positions.count(leaf.id) != 0; }
+
+    void add(VId leaf) {
+        if (contains(leaf)) { return; }
+        order.push_back(leaf);
+        positions.insert({leaf.id, std::prev(order.end())});
+    }
+
+    void remove(VId leaf) {
+        auto it = positions.find(leaf.id);
+        if (it == positions.end()) { return; }
+        order.erase(it->second);
+        positions.erase(it);
+    }
+
+    // Newest leaf satisfying the predicate
+    template<typename TPred>
+    std::optional<VId> findNewest(TPred predicate) const {
+        auto it = std::find_if(order.rbegin(), order.rend(), predicate);
+        if (it == order.rend()) { return std::nullopt; }
+        return *it;
+    }
+
+    std::size_t size() const { return order.size(); }
 };
 
 
@@ -204,12 +282,16 @@ public:
         if (it != cache.end()) {
             return it->second;
         }
+        if (SyntacticImplication(logic).isValid(antecedent, consequent)) {
+            cache.insert({pair, QueryResult::VALID});
+            return QueryResult::VALID;
+        }
         SMTConfig config;
         MainSolver solver(logic, config, "implication_checker");
         PTRef negImpl = logic.mkAnd(antecedent, logic.mkNot(consequent)); // not(A->B) iff A and (not B)
 //        std::cout << logic.printTerm(negImpl) << std::endl;
         solver.insertFormula(negImpl);
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "lawi.implication");
         if (res == s_True) {
             cache.insert({pair, QueryResult::INVALID});
             return QueryResult::INVALID;
@@ -228,7 +310,7 @@ public:
         throw std::logic_error("Unreachable code!");
     }
 
-    QueryResult checkImplicationWithHints(PTRef antecedent, PTRef consequent, std::vector<std::unique_ptr<Model>>& antecedentModels) {
+    QueryResult checkImplicationWithSamples(PTRef antecedent, PTRef consequent, SampleSet & samples) {
         if (antecedent == consequent || antecedent == logic.getTerm_false() || consequent == logic.getTerm_true()) {
             return QueryResult::VALID;
         }
@@ -240,22 +322,23 @@ public:
         if (it != cache.end()) {
             return it->second;
         }
-        for (auto const& model : antecedentModels) {
-            assert(model->evaluate(antecedent) == logic.getTerm_true());
-            if (model->evaluate(consequent) == logic.getTerm_false()) {
-                cache.insert({pair, QueryResult::INVALID});
-                return QueryResult::INVALID;
-            }
+        if (SyntacticImplication(logic).isValid(antecedent, consequent)) {
+            cache.insert({pair, QueryResult::VALID});
+            return QueryResult::VALID;
+        }
+        if (samples.refutes(antecedent, consequent)) {
+            cache.insert({pair, QueryResult::INVALID});
+            return QueryResult::INVALID;
         }
         SMTConfig config;
         MainSolver solver(logic, config, "implication_checker");
         PTRef negImpl = logic.mkAnd(antecedent, logic.mkNot(consequent)); // not(A->B) iff A and (not B)
 //        std::cout << logic.printTerm(negImpl) << std::endl;
         solver.insertFormula(negImpl);
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "lawi.implication");
         if (res == s_True) {
             cache.insert({pair, QueryResult::INVALID});
-            antecedentModels.push_back(solver.getModel());
+            samples.addSample(solver.getModel());
             return QueryResult::INVALID;
         }
         if (res == s_False) {
@@ -277,17 +360,88 @@ private:
     std::unordered_map<std::pair<PTRef, PTRef>, QueryResult, PTRefPairHash> cache;
 };
 
+/*
+ * Incremental interpolating solver holding the path from the root of the ART to the last checked vertex.
+ *
+ * Every path segment is inserted on its own push level, so checking a different path only pops the segments
+ * that are not shared with the new path and pushes the new ones.
+ * Partitions are numbered by the order of insertion, including the segments that have been popped since.
+ */
+class PathSolver {
+    struct Segment {
+        EId edge;
+        unsigned partition;
+    };
+    std::unique_ptr<SMTConfig> config;
+    std::unique_ptr<MainSolver> solver;
+    std::vector<Segment> segments;
+    unsigned formulasInserted = 0;
+
+public:
+    PathSolver(Logic & logic, std::unique_ptr<SMTConfig> config) : config(std::move(config)) {
+        solver = std::make_unique<MainSolver>(logic, *this->config, "path checker");
+    }
+
+    template<typename TSegmentFormula>
+    sstat checkPath(std::vector<EId> const & edges, TSegmentFormula segmentFormula) {
+        std::size_t common = 0;
+        while (common < segments.size() and common < edges.size() and segments[common].edge == edges[common]) {
+            ++common;
+        }
+        while (segments.size() > common) {
+            solver->pop();
+            segments.pop_back();
+        }
+        for (std::size_t i = common; i < edges.size(); ++i) {
+            solver->push();
+            solver->insertFormula(segmentFormula(edges[i], i));
+            segments.push_back(Segment{edges[i], formulasInserted++});
+        }
+        return QueryDump::check(*solver, "lawi.refine");
+    }
+
+    // Applies to the interpolants computed from now on, including those of the last path
+    void setInterpolationAlgorithm(ItpAlgorithm algorithm) {
+        config->setLRAInterpolationAlgorithm(algorithm);
+    }
+
+    // Interpolants after each segment of the last (infeasible) path, the last one is always false
+    vec<PTRef> getPathInterpolants(Logic & logic) {
+        vec<ipartitions_t> masks;
+        ipartitions_t mask = 0;
+        for (std::size_t i = 0; i + 1 < segments.size(); ++i) {
+            opensmt::setbit(mask, segments[i].partition);
+            masks.push(mask);
+        }
+        vec<PTRef> pathInterpolants;
+        solver->getInterpolationContext()->getPathInterpolants(pathInterpolants, masks);
+        pathInterpolants.push(logic.getTerm_false());
+        assert(pathInterpolants.size_() == segments.size());
+        return pathInterpolants;
+    }
+};
+
 class LawiContext{
     Logic & logic;
-    ChcDirectedGraph const & graph;
+    ChcDirectedGraph const & originalGraph;
     Options const & options;
+    // If present, the tree is built over the edges of the block graph instead of the original graph
+    std::unique_ptr<LargeBlockEncoding> blockEncoding;
+    ChcDirectedGraph const & graph;
 
     AbstractReachabilityTree art;
     LabelingFunction labels;
     CoveringRelation coveringRelation;
     ImplicationChecker implicationChecker;
+    SampleStore samples;
+    InterpolationAlgorithmSelector itpSelector;
+    PathSolver pathSolver;
+    // Arm of the selector used in the last refinement, rewarded once we know if the refinement led to a covering
+    std::optional<std::size_t> pendingArm;
 
-    std::vector<VId> leavesToCheck;
+    LeafSet leavesToCheck;
+    // Vertices covered since the last pruning; their subtrees are removed if they are still covered at that point
+    std::vector<VId> recentlyCovered;
 
     bool usingForcedCovering;
     std::size_t forceCoveringLimit = 1;
@@ -295,9 +449,19 @@ class LawiContext{
     ErrorPath errorPath;
 
     void removeLeaf(VId leaf) {
-        leavesToCheck.erase(std::remove(leavesToCheck.begin(), leavesToCheck.end(), leaf), leavesToCheck.end());
+        leavesToCheck.remove(leaf);
     }
 
+    void forgetVertices(std::vector<VId> const & removed) {
+        for (VId vertex : removed) {
+            labels.removeLabel(vertex);
+            leavesToCheck.remove(vertex);
+        }
+        coveringRelation.verticesRemoved(removed);
+    }
+
+    void pruneCoveredSubtrees();
+
     std::vector<VId> getAncestorsOf(VId vertex) const { return art.getAncestorsOfExcluding(vertex); }
     std::vector<VId> getEarlierForSameLocationAs(VId vertex) const { return art.getEarlierForSameLocationAs(vertex); }
     void closeAllAncestors(VId vertex) {
@@ -313,8 +477,9 @@ class LawiContext{
         return implicationChecker.checkImplication(antecedent, consequent);
     }
 
-    ImplicationCheckResult checkImplicationWithHints(PTRef antecedent, PTRef consequent, std::vector<std::unique_ptr<Model>>& antecedentModels) {
-        return implicationChecker.checkImplicationWithHints(antecedent, consequent, antecedentModels);
+    // Counter-models found for one covering check are kept per location and reused in later checks
+    ImplicationCheckResult checkImplicationWithSamples(PTRef antecedent, PTRef consequent, SymRef location) {
+        return implicationChecker.checkImplicationWithSamples(antecedent, consequent, samples.getSamples(location));
     }
 
     void expand(VId vertex);
@@ -326,10 +491,12 @@ class LawiContext{
 
     RefinementResult refine(VId vertex);
 
+    vec<PTRef> computePathInterpolants();
+
     [[maybe_unused]]
     void cover(VId v, VId w);
 
-    bool coverWithHints(VId v, VId w, std::vector<std::unique_ptr<Model>>& vModels);
+    bool coverWithSamples(VId v, VId w);
 
     void close(VId vertex);
 
@@ -343,31 +510,33 @@ class LawiContext{
         bool set = config->setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
         assert(set); (void)set;
         config->setSimplifyInterpolant(4);
-        if (options.hasOption(Options::LRA_ITP_ALG)) {
-            int algNumber = std::atoi(options.getOption(Options::LRA_ITP_ALG).c_str());
-            config->setLRAInterpolationAlgorithm(ItpAlgorithm{algNumber});
-        }
+        // Queries outside of refinement always use the first algorithm of the selector
+        config->setLRAInterpolationAlgorithm(itpSelector.algorithm(0));
         return std::unique_ptr<SMTConfig>(config);
     }
 
     vec<PTRef> normalizeInterpolants(vec<PTRef> const & itps) const;
 
-    std::vector<VId> strengthenLabelsAlongPath(const ArtPath & path, vec<PTRef> const & itps);
+    std::vector<VId> strengthenLabelsAlongPath(std::vector<EId> const & path, vec<PTRef> const & itps);
 
     bool useForcedCovering() const { return usingForcedCovering; }
 
-    ErrorPath buildGraphPathFromTreePath(ArtPath const & path) const;
+    ErrorPath buildGraphPathFromTreePath(std::vector<EId> const & path) const;
 public:
     LawiContext(Logic & logic, ChcDirectedGraph const& graph, Options const & options)
-        : logic(logic), graph(graph), options(options), art(graph), coveringRelation(art), implicationChecker(logic) {
+        : logic(logic), originalGraph(graph), options(options),
+          blockEncoding(options.hasOption(Options::LAWI_BLOCK_ENCODING) ? std::make_unique<LargeBlockEncoding>(logic, graph) : nullptr),
+          graph(blockEncoding ? blockEncoding->getBlockGraph() : graph),
+          art(this->graph), coveringRelation(art), implicationChecker(logic), samples(logic),
+          itpSelector(options), pathSolver(logic, createInterpolatingConfig()) {
         labels.addLabel(art.getRoot(), logic.getTerm_true());
-        leavesToCheck.push_back(art.getRoot());
+        leavesToCheck.add(art.getRoot());
         usingForcedCovering = options.hasOption(Options::FORCED_COVERING);
     }
 
     VerificationResult unwind();
 
-    vec<PTRef> getPathInterpolants(MainSolver & solver, ArtPath const &) const;
+    void printStatistics() const;
 
     void applyForcedCovering(VId vertex);
 };
@@ -378,10 +547,9 @@ public:
 
 void LawiContext::close(VId vertex) {
     auto before = getEarlierForSameLocationAs(vertex);
-    std::vector<std::unique_ptr<Model>> vertexModels;
     for (VId earlier : before) {
         if (not coveringRelation.isCovered(earlier)) {
-            bool covered = coverWithHints(vertex, earlier, vertexModels);
+            bool covered = coverWithSamples(vertex, earlier);
             if (covered) { return; }
         }
     }
@@ -398,11 +566,14 @@ VerificationResult LawiContext::unwind() {
         auto res = DFS(uncoveredVertex);
         if (res == VerificationAnswer::UNSAFE) {
             if (computeWitness) {
-                return VerificationResult(VerificationAnswer::UNSAFE, InvalidityWitness::fromErrorPath(errorPath, graph));
+                return VerificationResult(VerificationAnswer::UNSAFE, InvalidityWitness::fromErrorPath(errorPath, originalGraph));
             } else {
                 return VerificationResult(VerificationAnswer::UNSAFE);
             }
         }
+        pruneCoveredSubtrees();
+        // LAWI explores paths depth-first, so there is no bound below which all paths have been refuted
+        GOLEM_PROGRESS("lawi", std::nullopt, leavesToCheck.size())
         optionalVertex = getUncoveredLeaf();
     }
     if (not computeWitness) { return VerificationResult(VerificationAnswer::SAFE); }
@@ -438,6 +609,9 @@ VerificationResult LawiContext::unwind() {
             throw std::logic_error("Duplicate definition for a predicate encountered!");
         }
     }
+    if (blockEncoding) {
+        solution = blockEncoding->extendSolution(std::move(solution));
+    }
     return VerificationResult(VerificationAnswer::SAFE, ValidityWitness(std::move(solution)));
 }
 
@@ -455,6 +629,13 @@ VerificationAnswer LawiContext::DFS(VId vertex) {
         for (VId strengthened : res.refinedVertices) {
             close(strengthened);
         }
+        // The interpolants were useful if they allowed to cover some of the strengthened vertices
+        if (pendingArm.has_value() and not res.refinedVertices.empty()) {
+            bool covered = std::any_of(res.refinedVertices.begin(), res.refinedVertices.end(),
+                                       [this](VId refined) { return coveringRelation.isCovered(refined); });
+            itpSelector.reward(pendingArm.value(), covered ? 1.0 : 0.0);
+        }
+        pendingArm.reset();
     }
     else {
         expand(vertex);
@@ -487,6 +668,7 @@ void LawiContext::applyForcedCovering(VId vertex) {
         auto edgeFormulas = path.getEdgeFormulas();
         auto config = createInterpolatingConfig();
         MainSolver solver(logic, *config, "forcedCoveringChecker");
+        // Partition 0 is the label of the nearest common ancestor, partition i is the i-th edge of the path
         solver.insertFormula(labels.getLabel(nca));
 //        std::cout << logic.printTerm(labels.getLabel(nca)) << std::endl;
         for (PTRef edge : edgeFormulas) {
@@ -498,18 +680,25 @@ void LawiContext::applyForcedCovering(VId vertex) {
         solver.insertFormula(logic.mkNot(labelToTest));
 //        PTRef fla = logic.mkAnd({labels.getLabel(nca), logic.mkAnd(edgeFormulas), logic.mkNot(labelToTest)});
 //        std::cout << logic.printTerm(fla) << std::endl;
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "lawi.forced-covering");
         if (res == s_False) {
             // this vertex is covered by the candidate
             // compute interpolants, strenthen the labels
             auto edges = path.getEdges();
             assert(not edges.empty() && art.getSource(edges.front()) == nca && art.getTarget(edges.back()) == vertex);
-            // Interpolation
-            vec<PTRef> pathInterpolants = getPathInterpolants(solver, path);
+            // Interpolation, the interpolant after the last edge separates the path from the negated label to test
+            vec<ipartitions_t> masks;
+            ipartitions_t mask = 0;
+            opensmt::setbit(mask, 0);
+            for (std::size_t i = 0; i < edges.size(); ++i) {
+                opensmt::setbit(mask, i + 1);
+                masks.push(mask);
+            }
+            vec<PTRef> pathInterpolants;
+            solver.getInterpolationContext()->getPathInterpolants(pathInterpolants, masks);
             vec<PTRef> normalizedInterpolants = normalizeInterpolants(pathInterpolants);
-            strengthenLabelsAlongPath(path, normalizedInterpolants);
+            strengthenLabelsAlongPath(edges, normalizedInterpolants);
             // Don't forget to update the label of the last vertex in the path
-            assert(labels.getLabel(vertex) == logic.getTerm_true());
             labels.replaceLabel(vertex, labels.getLabel(candidate));
             break; // label has been propagated
         }
@@ -521,15 +710,15 @@ void LawiContext::expand(VId vertex) {
     assert(art.isLeaf(vertex) && not coveringRelation.isCovered(vertex));
     auto children = art.expand(vertex);
     for (auto child : children) {
-        leavesToCheck.push_back(child);
+        leavesToCheck.add(child);
     }
     removeLeaf(vertex);
 }
 
 LawiContext::RefinementResult LawiContext::refine(VId errVertex) {
+    GOLEM_TRACE_SCOPE("lawi.refine");
     assert(art.isErrorLocation(errVertex));
-    ArtPath path = art.getPathFromInit(errVertex, logic);
-    auto edgeFormulas = path.getEdgeFormulas();
+    auto edges = art.getAncestorPathUntil(errVertex, art.getRoot());
     /*
      * 1. check satisfiability
      * 2. if SAT -> return UNSAFE
@@ -537,48 +726,72 @@ LawiContext::RefinementResult LawiContext::refine(VId errVertex) {
      * 4. normalize to current state formulas
      * 5. if not implied by current label -> strengthen label and potentially uncover vertices
      */
-//    std::cout << "\nChecking path: " << logic.printTerm(logic.mkAnd(edgeFormulas)) << std::endl;
-//    std::cout << "\nChecking path of length " << edgeFormulas.size() << std::endl;
-    auto config = createInterpolatingConfig();
-    MainSolver solver(logic, *config, "checker");
-    for (PTRef segment : edgeFormulas) {
-//    	std::cout << logic.printTerm(segment) << std::endl;
-        solver.insertFormula(segment);
-    }
-    auto res = solver.check();
+    // Only the segments not shared with the previously checked path are asserted
+    auto res = pathSolver.checkPath(edges, [this](EId edge, std::size_t depth) {
+        return TimeMachine(logic).sendFlaThroughTime(art.getLabel(edge), depth);
+    });
     if (res == s_True) {
-        errorPath = buildGraphPathFromTreePath(path);
+        errorPath = buildGraphPathFromTreePath(edges);
         return RefinementResult{VerificationAnswer::UNSAFE, {}};
     } else if (res == s_False) {
-		auto edges = path.getEdges();
 		assert(not edges.empty() and art.getSource(edges.front()) == this->art.getRoot()
 			and art.isErrorLocation(art.getTarget(edges.back())));
         // Interpolation
-        vec<PTRef> pathInterpolants = getPathInterpolants(solver, path);
+        vec<PTRef> pathInterpolants = computePathInterpolants();
         vec<PTRef> normalizedInterpolants = normalizeInterpolants(pathInterpolants);
-        auto strengthened = strengthenLabelsAlongPath(path, normalizedInterpolants);
-        // this vertex does not have to be considered anymore
-        removeLeaf(errVertex);
+        auto strengthened = strengthenLabelsAlongPath(edges, normalizedInterpolants);
+        // this vertex does not have to be considered anymore, the refuted error vertex is removed from the tree
+        strengthened.erase(std::remove(strengthened.begin(), strengthened.end(), errVertex), strengthened.end());
+        art.removeLeaf(errVertex);
+        forgetVertices({errVertex});
         return RefinementResult{VerificationAnswer::UNKNOWN, std::move(strengthened)};
     } else {
         throw std::logic_error("Error in the SMT solver");
     }
 }
 
-vec<PTRef> LawiContext::getPathInterpolants(MainSolver & solver, ArtPath const & path) const {
-    auto itpContext = solver.getInterpolationContext();
-    vec<PTRef> pathInterpolants;
-    auto pathSize = path.size();
-    // Create the partitions manually, TODO: fix the OpenSMT interface so that calling just getPathInterpolants would work correctly
-    ipartitions_t mask = 0;
-    for (std::size_t i = 0; i < pathSize - 1; ++i) {
-        opensmt::setbit(mask, i);
-        itpContext->getSingleInterpolant(pathInterpolants, mask);
+vec<PTRef> LawiContext::computePathInterpolants() {
+    switch (itpSelector.getMode()) {
+        case InterpolationAlgorithmSelector::Mode::FIXED:
+            return pathSolver.getPathInterpolants(logic);
+        case InterpolationAlgorithmSelector::Mode::ADAPTIVE: {
+            std::size_t arm = itpSelector.select();
+            pathSolver.setInterpolationAlgorithm(itpSelector.algorithm(arm));
+            pendingArm = arm;
+            return pathSolver.getPathInterpolants(logic);
+        }
+        case InterpolationAlgorithmSelector::Mode::SMALLEST: {
+            // All algorithms work with the same proof of the last path, only the smallest sequence is kept
+            vec<PTRef> smallest;
+            std::size_t smallestSize = 0;
+            std::size_t winner = 0;
+            for (std::size_t arm = 0; arm < itpSelector.armCount(); ++arm) {
+                pathSolver.setInterpolationAlgorithm(itpSelector.algorithm(arm));
+                vec<PTRef> candidate = pathSolver.getPathInterpolants(logic);
+                std::size_t size = 0;
+                for (int i = 0; i < candidate.size(); ++i) {
+                    size += InterpolationAlgorithmSelector::dagSize(logic, candidate[i]);
+                }
+                if (arm == 0 or size < smallestSize) {
+                    candidate.copyTo(smallest);
+                    smallestSize = size;
+                    winner = arm;
+                }
+            }
+            for (std::size_t arm = 0; arm < itpSelector.armCount(); ++arm) {
+                itpSelector.reward(arm, arm == winner ? 1.0 : 0.0);
+            }
+            return smallest;
+        }
+    }
+    throw std::logic_error("Unknown mode of interpolation algorithm selection");
+}
+
+void LawiContext::printStatistics() const {
+    int verbosity = options.hasOption(Options::VERBOSE) ? std::stoi(options.getOption(Options::VERBOSE)) : 0;
+    if (verbosity > 0) {
+        itpSelector.printStatistics(std::cout, "LAWI");
     }
-    // MB: Last interpolant must be always false
-    pathInterpolants.push(logic.getTerm_false());
-    assert(pathInterpolants.size_() == pathSize);
-    return pathInterpolants;
 }
 
 // 'coveree' can be covered by 'coverer'
@@ -590,16 +803,19 @@ void LawiContext::cover(VId coveree, VId coverer) {
     auto res = checkImplication(labels.getLabel(coveree), labels.getLabel(coverer));
     if (res == decltype(res)::VALID) {
         coveringRelation.updateWith({.coveree = coveree, .coverer = coverer});
+        recentlyCovered.push_back(coveree);
         // if coveree was covering something, this must be removed
     }
 }
 
-bool LawiContext::coverWithHints(VId coveree, VId coverer, std::vector<std::unique_ptr<Model>>& covereeModels) {
+bool LawiContext::coverWithSamples(VId coveree, VId coverer) {
     if (coveringRelation.isCovered(coveree)) { return true; }
     if (not art.sameLocation(coveree, coverer) || art.isAncestor(coveree, coverer)) { return false; }
-    auto res = checkImplicationWithHints(labels.getLabel(coveree), labels.getLabel(coverer), covereeModels);
+    auto location = art.getOriginalLocation(coveree);
+    auto res = checkImplicationWithSamples(labels.getLabel(coveree), labels.getLabel(coverer), location);
     if (res == decltype(res)::VALID) {
         coveringRelation.updateWith({.coveree = coveree, .coverer = coverer});
+        recentlyCovered.push_back(coveree);
         return true;
     }
     return false;
@@ -626,6 +842,16 @@ bool CoveringRelation::isCovered(VId vertex) const {
     });
 }
 
+void CoveringRelation::verticesRemoved(std::vector<VId> const & vertices) {
+    std::unordered_set<std::size_t> removedIds;
+    removedIds.reserve(vertices.size());
+    for (VId vertex : vertices) { removedIds.insert(vertex.id); }
+    auto removed = [&removedIds](VId vertex) { return removedIds.count(vertex.id) > 0; };
+    elements.erase(std::remove_if(elements.begin(), elements.end(), [&](CoveringRelation::RelElement const & elem) {
+        return removed(elem.coveree) or removed(elem.coverer);
+    }), elements.end());
+}
+
 void CoveringRelation::vertexStrengthened(VId vertex) {
     elements.erase(std::remove_if(elements.begin(), elements.end(), [vertex](CoveringRelation::RelElement const & elem) {
         return elem.coverer == vertex;
@@ -650,6 +876,25 @@ std::vector<VId> AbstractReachabilityTree::expand(VId vertex) {
     return children;
 }
 
+std::vector<VId> AbstractReachabilityTree::removeDescendantsOf(VId vertex) {
+    auto descendants = getDescendantsOfIncluding(vertex);
+    assert(not descendants.empty() and descendants.front() == vertex);
+    descendants.erase(descendants.begin());
+    for (VId descendant : descendants) {
+        removeVertex(descendant);
+    }
+    childrenOf.erase(vertex);
+    return descendants;
+}
+
+void AbstractReachabilityTree::removeLeaf(VId leaf) {
+    assert(isLeaf(leaf) and leaf != root);
+    EId incoming = parentOf.at(leaf);
+    auto & siblings = childrenOf.at(getSource(incoming));
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), incoming), siblings.end());
+    removeVertex(leaf);
+}
+
 bool AbstractReachabilityTree::isAncestor(VId ancestor, VId descendant) const {
     VId current = descendant;
     while (current != ancestor && current != root) {
@@ -713,18 +958,17 @@ std::vector<EId> AbstractReachabilityTree::getOutEdgesOf(VId vertex) const {
 std::vector<VId> AbstractReachabilityTree::getChildrenOf(VId vertex) const {
     auto outEdges = getOutEdgesOf(vertex);
     std::vector<VId> children;
-    std::transform(outEdges.begin(), outEdges.end(), std::back_inserter(children), [this](EId outEdge) { return this->edges[outEdge.id].to; });
+    std::transform(outEdges.begin(), outEdges.end(), std::back_inserter(children), [this](EId outEdge) { return getTarget(outEdge); });
     return children;
 }
 
 std::vector<VId> AbstractReachabilityTree::getEarlierForSameLocationAs(VId vertex, size_t limit) const {
     std::vector<VId> res;
     if (vertex.id == 0) { return res; }
-    for (std::size_t id = vertex.id - 1; id > 0 && res.size() < limit; --id) {
-        VId other{id};
-        if (sameLocation(vertex, other)) {
-            res.push_back(other);
-        }
+    auto const & sameLocationVertices = verticesOf.at(getOriginalLocation(vertex));
+    for (auto it = std::make_reverse_iterator(sameLocationVertices.lower_bound(vertex.id));
+         it != sameLocationVertices.rend() && *it > 0 && res.size() < limit; ++it) {
+        res.push_back(VId{*it});
     }
     return res;
 }
@@ -768,11 +1012,11 @@ PTRef AbstractReachabilityTree::getLabel(EId eid) const {
 }
 
 VId AbstractReachabilityTree::getSource(EId eid) const {
-	return edges[eid.id].from;
+	return edges.at(eid.id).from;
 }
 
 VId AbstractReachabilityTree::getTarget(EId eid) const {
-	return edges[eid.id].to;
+	return edges.at(eid.id).to;
 }
 
 void AbstractReachabilityTree::traverse(std::function<void(VId)> fun) const {
@@ -798,14 +1042,27 @@ VId AbstractReachabilityTree::nearestCommonAncestor(VId v1, VId v2) const {
 }
 
 std::optional<VId> LawiContext::getUncoveredLeaf() {
-    for (auto it = leavesToCheck.rbegin(); it != leavesToCheck.rend(); ++it) {
-        VId vid = *it;
+    return leavesToCheck.findNewest([this](VId vid) {
         assert(art.isLeaf(vid));
-        if (not coveringRelation.isCovered(vid)) {
-            return vid;
-        }
+        return not coveringRelation.isCovered(vid);
+    });
+}
+
+/*
+ * Subtrees of covered vertices are never explored again unless the covering is broken by strengthening the coverer.
+ * Coverings that survived until the end of the DFS round in which they were established are considered stable and
+ * the subtree below the covered vertex is removed. The covered vertex itself stays as a leaf, so that it can be
+ * expanded again if it is ever uncovered.
+ */
+void LawiContext::pruneCoveredSubtrees() {
+    auto candidates = std::move(recentlyCovered);
+    recentlyCovered.clear();
+    for (VId vertex : candidates) {
+        if (not art.contains(vertex) or art.isLeaf(vertex) or not coveringRelation.isCovered(vertex)) { continue; }
+        auto removed = art.removeDescendantsOf(vertex);
+        forgetVertices(removed);
+        leavesToCheck.add(vertex);
     }
-    return std::nullopt;
 }
 
 vec<PTRef> LawiContext::normalizeInterpolants(const vec<PTRef> & itps) const {
@@ -817,7 +1074,7 @@ vec<PTRef> LawiContext::normalizeInterpolants(const vec<PTRef> & itps) const {
     return normalized;
 }
 
-std::vector<VId> LawiContext::strengthenLabelsAlongPath(const ArtPath & path, const vec<PTRef> & itps) {
+std::vector<VId> LawiContext::strengthenLabelsAlongPath(std::vector<EId> const & path, const vec<PTRef> & itps) {
     auto vertices = art.getPathVertices(path);
     assert(vertices.size() == itps.size_() + 1);
     std::vector<VId> refinedVertices;
@@ -838,12 +1095,27 @@ std::vector<VId> LawiContext::strengthenLabelsAlongPath(const ArtPath & path, co
     return refinedVertices;
 }
 
-ErrorPath LawiContext::buildGraphPathFromTreePath(const ArtPath & path) const {
-    auto edges = path.getEdges();
+ErrorPath LawiContext::buildGraphPathFromTreePath(std::vector<EId> const & edges) const {
 	std::vector<EId> originalEdges;
     std::transform(edges.begin(), edges.end(), std::back_inserter(originalEdges),
 				   [this](EId eid) { return art.getOriginalEdge(eid); });
-    return ErrorPath(std::move(originalEdges));
+    if (not blockEncoding) {
+        return ErrorPath(std::move(originalEdges));
+    }
+    // Block edges are expanded to the paths of the original graph taken in a model of the path formula
+    SMTConfig config;
+    const char * msg = "ok";
+    config.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
+    MainSolver solver(logic, config, "LAWI counterexample");
+    TimeMachine timeMachine(logic);
+    for (std::size_t i = 0; i < originalEdges.size(); ++i) {
+        solver.insertFormula(timeMachine.sendFlaThroughTime(graph.getEdgeLabel(originalEdges[i]), static_cast<int>(i)));
+    }
+    if (QueryDump::check(solver, "lawi.counterexample") != s_True) {
+        throw std::logic_error("LAWI: Counterexample path is not feasible!");
+    }
+    auto model = solver.getModel();
+    return ErrorPath(blockEncoding->expandPath(originalEdges, *model));
 }
 
 }
@@ -863,5 +1135,7 @@ VerificationResult Lawi::solve(ChcDirectedHyperGraph & graph) {
 
 VerificationResult Lawi::solve(ChcDirectedGraph const & graph) {
     LawiContext ctx(logic, graph, options);
-    return ctx.unwind();
+    auto result = ctx.unwind();
+    ctx.printStatistics();
+    return result;
 }
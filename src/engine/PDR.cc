@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "PDR.h"
+
+#include "ModelBasedProjection.h"
+#include "Progress.h"
+#include "QueryDump.h"
+#include "TermUtils.h"
+#include "TransformationUtils.h"
+#include "transformers/BasicTransformationPipelines.h"
+
+#include <algorithm>
+#include <queue>
+
+VerificationResult PDR::solve(ChcDirectedHyperGraph & graph) {
+    auto pipeline = Transformations::towardsTransitionSystems();
+    auto transformationResult = pipeline.transform(std::make_unique<ChcDirectedHyperGraph>(graph));
+    auto transformedGraph = std::move(transformationResult.first);
+    auto translator = std::move(transformationResult.second);
+    if (transformedGraph->isNormalGraph()) {
+        auto normalGraph = transformedGraph->toNormalGraph();
+        auto res = solve(*normalGraph);
+        return computeWitness ? translator->translate(std::move(res)) : res;
+    }
+    return VerificationResult(VerificationAnswer::UNKNOWN);
+}
+
+VerificationResult PDR::solve(ChcDirectedGraph const & system) {
+    if (isTransitionSystem(system)) {
+        auto ts = toTransitionSystem(system, logic);
+        return solveTransitionSystem(*ts, system);
+    }
+    return VerificationResult(VerificationAnswer::UNKNOWN);
+}
+
+namespace {
+struct ProofObligation {
+    PTRef states;
+    std::size_t level;
+    std::size_t depth; // number of steps from the states to the bad states
+};
+
+struct LowerLevelFirst {
+    bool operator()(ProofObligation const & first, ProofObligation const & second) const {
+        return first.level > second.level or (first.level == second.level and first.depth < second.depth);
+    }
+};
+
+class FrameSolver {
+    SMTConfig config;
+    std::unique_ptr<MainSolver> solver;
+public:
+    FrameSolver(Logic & logic, PTRef base) {
+        const char * msg = "ok";
+        config.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
+        config.setOption(SMTConfig::o_produce_inter, SMTOption(false), msg);
+        solver = std::make_unique<MainSolver>(logic, config, "PDR frame");
+        solver->insertFormula(base);
+    }
+
+    void addLemma(PTRef lemma) { solver->insertFormula(lemma); }
+
+    sstat checkWith(vec<PTRef> const & assumptions) {
+        solver->push();
+        for (PTRef fla : assumptions) {
+            solver->insertFormula(fla);
+        }
+        auto res = QueryDump::check(*solver, "pdr.frame");
+        if (res != s_True) {
+            solver->pop();
+        }
+        if (res == s_Undef) {
+            throw std::logic_error("PDR: Solver could not decide a query!");
+        }
+        return res;
+    }
+
+    // Must be called after a successful check, pops the assumptions
+    std::unique_ptr<Model> getModelAndPop() {
+        auto model = solver->getModel();
+        solver->pop();
+        return model;
+    }
+
+    void pop() { solver->pop(); }
+};
+
+class PDRContext {
+    Logic & logic;
+    TransitionSystem const & system;
+    int verbosity;
+    PTRef init;
+    PTRef transition;
+    vec<PTRef> stateVars;
+    TimeMachine tm;
+    FrameSolver initSolver;
+    // frames[i] holds the solver for F_i /\ T; frame 0 is the initial states
+    std::vector<std::unique_ptr<FrameSolver>> frames;
+    // deltas[i] holds lemmas that hold in F_0, ..., F_i, but are not known to hold in F_{i+1}
+    std::vector<std::vector<PTRef>> deltas;
+    std::size_t stepsToBug = 0;
+
+public:
+    PDRContext(Logic & logic, TransitionSystem const & system, int verbosity) :
+        logic(logic), system(system), verbosity(verbosity), init(system.getInit()),
+        transition(system.getTransition()), tm(logic), initSolver(logic, system.getInit()) {
+        for (PTRef var : system.getStateVars()) {
+            stateVars.push(var);
+        }
+        frames.push_back(std::make_unique<FrameSolver>(logic, logic.mkAnd(init, transition)));
+        deltas.emplace_back();
+    }
+
+    enum class Answer : char { SAFE, UNSAFE };
+
+    Answer run(PTRef & invariant);
+
+    std::size_t getStepsToBug() const { return stepsToBug; }
+
+private:
+    std::size_t currentLevel() const { return frames.size() - 1; }
+
+    void newFrame() {
+        frames.push_back(std::make_unique<FrameSolver>(logic, transition));
+        deltas.emplace_back();
+    }
+
+    bool intersectsInit(PTRef states) {
+        if (initSolver.checkWith({states}) == s_True) {
+            initSolver.pop();
+            return true;
+        }
+        return false;
+    }
+
+    PTRef nextState(PTRef fla) { return tm.sendFlaThroughTime(fla, 1); }
+
+    PTRef conjunctionOf(std::vector<PTRef> const & literals) {
+        vec<PTRef> args;
+        for (PTRef literal : literals) {
+            args.push(literal);
+        }
+        return logic.mkAnd(std::move(args));
+    }
+
+    void addLemma(PTRef lemma, std::size_t level);
+
+    bool block(std::size_t level);
+
+    PTRef generalize(PTRef cube, std::size_t level);
+
+    // Returns true if a fixed point has been found, the invariant is then stored in the argument
+    bool propagate(PTRef & invariant);
+};
+
+PDRContext::Answer PDRContext::run(PTRef & invariant) {
+    PTRef query = system.getQuery();
+    if (intersectsInit(query)) {
+        stepsToBug = 0;
+        return Answer::UNSAFE;
+    }
+    newFrame();
+    while (true) {
+        if (not block(currentLevel())) {
+            return Answer::UNSAFE;
+        }
+        if (verbosity > 0) {
+            std::cout << "; PDR: Bad states blocked at level " << currentLevel() << std::endl;
+        }
+        GOLEM_PROGRESS("pdr", currentLevel(), frames.size())
+        newFrame();
+        if (propagate(invariant)) {
+            return Answer::SAFE;
+        }
+    }
+}
+
+bool PDRContext::block(std::size_t level) {
+    std::priority_queue<ProofObligation, std::vector<ProofObligation>, LowerLevelFirst> obligations;
+    obligations.push(ProofObligation{system.getQuery(), level, 0});
+    while (not obligations.empty()) {
+        ProofObligation pob = obligations.top();
+        assert(pob.level > 0);
+        if (intersectsInit(pob.states)) {
+            stepsToBug = pob.depth;
+            return false;
+        }
+        PTRef nextStates = nextState(pob.states);
+        auto & predecessorFrame = *frames[pob.level - 1];
+        if (predecessorFrame.checkWith({nextStates}) == s_True) {
+            auto model = predecessorFrame.getModelAndPop();
+            if (pob.level == 1) {
+                stepsToBug = pob.depth + 1;
+                return false;
+            }
+            PTRef predecessor = ModelBasedProjection(logic).keepOnly(logic.mkAnd(transition, nextStates), stateVars, *model);
+            if (verbosity > 1) {
+                std::cout << "; PDR: New proof obligation at level " << pob.level - 1 << ": " << logic.pp(predecessor) << std::endl;
+            }
+            obligations.push(ProofObligation{predecessor, pob.level - 1, pob.depth + 1});
+            continue;
+        }
+        obligations.pop();
+        PTRef cube = generalize(pob.states, pob.level);
+        addLemma(logic.mkNot(cube), pob.level);
+        if (pob.level < level) {
+            obligations.push(ProofObligation{pob.states, pob.level + 1, pob.depth});
+        }
+    }
+    return true;
+}
+
+/*
+ * Drops literals from the cube as long as the cube remains disjoint with the initial states
+ * and inductive relative to the previous frame.
+ */
+PTRef PDRContext::generalize(PTRef cube, std::size_t level) {
+    auto literals = TermUtils(logic).getTopLevelConjuncts(cube);
+    auto & predecessorFrame = *frames[level - 1];
+    std::vector<PTRef> kept(literals.begin(), literals.end());
+    for (std::size_t i = 0; i < kept.size() and kept.size() > 1;) {
+        std::vector<PTRef> candidateLiterals = kept;
+        candidateLiterals.erase(candidateLiterals.begin() + i);
+        PTRef candidate = conjunctionOf(candidateLiterals);
+        bool blocked = not intersectsInit(candidate);
+        if (blocked and predecessorFrame.checkWith({logic.mkNot(candidate), nextState(candidate)}) == s_True) {
+            predecessorFrame.pop();
+            blocked = false;
+        }
+        if (blocked) {
+            kept = std::move(candidateLiterals);
+        } else {
+            ++i;
+        }
+    }
+    return conjunctionOf(kept);
+}
+
+void PDRContext::addLemma(PTRef lemma, std::size_t level) {
+    if (verbosity > 1) {
+        std::cout << "; PDR: Adding lemma at level " << level << ": " << logic.pp(lemma) << std::endl;
+    }
+    deltas[level].push_back(lemma);
+    for (std::size_t i = 1; i <= level; ++i) {
+        frames[i]->addLemma(lemma);
+    }
+}
+
+bool PDRContext::propagate(PTRef & invariant) {
+    std::size_t const last = currentLevel();
+    for (std::size_t i = 1; i < last; ++i) {
+        auto lemmas = deltas[i];
+        for (PTRef lemma : lemmas) {
+            if (frames[i]->checkWith({nextState(logic.mkNot(lemma))}) == s_True) {
+                frames[i]->pop();
+                continue;
+            }
+            auto & current = deltas[i];
+            current.erase(std::find(current.begin(), current.end(), lemma));
+            deltas[i + 1].push_back(lemma);
+            frames[i + 1]->addLemma(lemma);
+        }
+        if (deltas[i].empty()) {
+            vec<PTRef> invariantLemmas;
+            for (std::size_t j = i + 1; j <= last; ++j) {
+                for (PTRef lemma : deltas[j]) {
+                    invariantLemmas.push(lemma);
+                }
+            }
+            invariant = logic.mkAnd(std::move(invariantLemmas));
+            if (verbosity > 0) {
+                std::cout << "; PDR: Fixed point found at level " << i << std::endl;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+VerificationResult PDR::solveTransitionSystem(TransitionSystem const & system, ChcDirectedGraph const & graph) {
+    PDRContext context(logic, system, verbosity);
+    PTRef invariant = PTRef_Undef;
+    auto answer = context.run(invariant);
+    if (answer == PDRContext::Answer::UNSAFE) {
+        if (verbosity > 0) {
+            std::cout << "; PDR: Bug found in depth: " << context.getStepsToBug() << std::endl;
+        }
+        if (computeWitness) {
+            return VerificationResult(VerificationAnswer::UNSAFE, InvalidityWitness::fromTransitionSystem(graph, context.getStepsToBug()));
+        }
+        return VerificationResult(VerificationAnswer::UNSAFE);
+    }
+    if (computeWitness) {
+        return VerificationResult(VerificationAnswer::SAFE, ValidityWitness::fromTransitionSystem(logic, graph, system, invariant));
+    }
+    return VerificationResult(VerificationAnswer::SAFE);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_PDR_H
+#define GOLEM_PDR_H
+
+#include "Engine.h"
+#include "TransitionSystem.h"
+
+/*
+ * IC3/PDR specialized for transition systems
+ *
+ * Frames are stored as delta frames (each lemma is stored only at the highest level where it is known to hold).
+ * Every frame has its own incremental solver with the transition relation and all lemmas of the frame;
+ * lemmas are only ever added to a frame, so individual queries are guarded by push/pop.
+ * Proof obligations are projected to state variables using model-based projection,
+ * blocked cubes are generalized by dropping literals.
+ */
+class PDR : public Engine {
+    Logic & logic;
+//    Options const & options;
+    int verbosity {0};
+    bool computeWitness {false};
+public:
+
+    PDR(Logic & logic, Options const & options) : logic(logic) {
+        if (options.hasOption(Options::VERBOSE)) {
+            verbosity = std::stoi(options.getOption(Options::VERBOSE));
+        }
+        if (options.hasOption(Options::COMPUTE_WITNESS)) {
+            computeWitness = options.getOption(Options::COMPUTE_WITNESS) == "true";
+        }
+    }
+
+    virtual VerificationResult solve(ChcDirectedHyperGraph & graph) override;
+
+    VerificationResult solve(ChcDirectedGraph const & system);
+
+private:
+    VerificationResult solveTransitionSystem(TransitionSystem const & system, ChcDirectedGraph const & graph);
+};
+
+
+#endif //GOLEM_PDR_H
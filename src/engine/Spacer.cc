@@ -6,15 +6,22 @@
 
 #include "Spacer.h"
 
+#include "FreeVariables.h"
+#include "MemoryAccounting.h"
 #include "ModelBasedProjection.h"
+#include "Progress.h"
+#include "QueryDump.h"
+#include "SampleStore.h"
+#include "SyntacticImplication.h"
+#include "Tracing.h"
 
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
 
-#define TRACE_LEVEL 0
+#define TRACE_LEVEL 1
 
-#define TRACE(l,m) if (TRACE_LEVEL >= l) { std::cout << m << std::endl; }
+#define TRACE(l,m) if (TRACE_LEVEL >= l) { GOLEM_TRACE_INSTANT(m) }
 
 class ApproxMap {
 public:
@@ -163,6 +170,16 @@ class SpacerContext {
 
     DerivationDatabase database;
     bool logProof;
+    int verbosity;
+
+    // Growth of the term store per bound and per component of the algorithm
+    mutable MemoryAccounting memory;
+
+    // Counterexamples to pushing lemmas, reused to refute pushing of other lemmas without calling the solver
+    SampleStore pushSamples;
+
+    // Models of satisfiable implication checks, stored per target vertex of the checked edge
+    mutable SampleStore implicationSamples;
 
     std::size_t lowestChangedLevel = 0;
 
@@ -206,9 +223,9 @@ class SpacerContext {
     enum class QueryAnswer : char {UNKNOWN, VALID, INVALID, ERROR};
     struct QueryResult {
         QueryAnswer answer;
-        std::unique_ptr<Model> model;
+        std::shared_ptr<Model> model;
     };
-    QueryResult implies(PTRef antecedent, PTRef consequent) const;
+    QueryResult implies(PTRef antecedent, PTRef consequent, SymRef vertex) const;
 
     struct ItpQueryResult {
         QueryAnswer answer;
@@ -219,7 +236,7 @@ class SpacerContext {
     struct MustReachResult {
         PTRef mustSummary = PTRef_Undef;
         bool applied = false;
-        std::unique_ptr<Model> model {nullptr};
+        std::shared_ptr<Model> model {nullptr};
     };
 
     MustReachResult mustReachable(EId eid, PTRef targetConstraint, std::size_t bound);
@@ -234,18 +251,25 @@ class SpacerContext {
 
     InvalidityWitness reconstructInvalidityWitness() const;
 public:
-    SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof);
+    SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof, int verbosity);
 
     VerificationResult run();
+
+    void reportMemory() const;
 };
 
 VerificationResult Spacer::solve(ChcDirectedHyperGraph & system) {
     bool logProof = options.hasOption(Options::COMPUTE_WITNESS) and options.getOption(Options::COMPUTE_WITNESS) == "true";
-    return SpacerContext(logic, system, logProof).run();
+    int verbosity = options.hasOption(Options::VERBOSE) ? std::stoi(options.getOption(Options::VERBOSE)) : 0;
+    SpacerContext context(logic, system, logProof, verbosity);
+    auto result = context.run();
+    context.reportMemory();
+    return result;
 }
 
-SpacerContext::SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof)
-    : logic(logic), graph(graph), logProof(logProof), vertexInstances(graph) {
+SpacerContext::SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof, int verbosity)
+    : logic(logic), graph(graph), logProof(logProof), verbosity(verbosity), memory(logic, "SPACER"), pushSamples(logic),
+      implicationSamples(logic), vertexInstances(graph) {
     auto vertices = graph.getVertices();
     for (auto vid : vertices) {
         PTRef toInsert = vid == graph.getEntry() ? logic.getTerm_true() : logic.getTerm_false();
@@ -287,6 +311,10 @@ VerificationResult SpacerContext::run() {
                     }
                     return {VerificationAnswer::SAFE, ValidityWitness(std::move(solution))};
                 }
+                if (verbosity > 0) {
+                    memory.printCheckpoint(std::cout, "bound " + std::to_string(currentBound));
+                }
+                GOLEM_PROGRESS("spacer", currentBound, std::nullopt)
                 ++currentBound;
                 break;
             }
@@ -297,6 +325,12 @@ VerificationResult SpacerContext::run() {
     }
 }
 
+void SpacerContext::reportMemory() const {
+    if (verbosity > 1) {
+        memory.printSummary(std::cout);
+    }
+}
+
 
 std::vector<EId> incomingEdges(SymRef v, ChcDirectedHyperGraph const & graph) {
     // TODO: Remember the adjacency representation and do not recompute this all the time
@@ -308,7 +342,7 @@ std::vector<EId> incomingEdges(SymRef v, ChcDirectedHyperGraph const & graph) {
 }
 
 SpacerContext::BoundedSafetyResult SpacerContext::boundSafety(std::size_t currentBound) {
-    TRACE(1, "\nRunning bounded safety check at level " << currentBound)
+    GOLEM_TRACE_SCOPE_DETAIL("spacer.bound", "bound " << currentBound);
     auto query = graph.getExit();
     PriorityQueue pqueue;
     pqueue.push(ProofObligation{query, currentBound, logic.getTerm_true()});
@@ -382,20 +416,28 @@ SpacerContext::BoundedSafetyResult SpacerContext::boundSafety(std::size_t curren
     return BoundedSafetyResult::SAFE; // not reachable at this bound
 }
 
-SpacerContext::QueryResult SpacerContext::implies(PTRef antecedent, PTRef consequent) const {
+SpacerContext::QueryResult SpacerContext::implies(PTRef antecedent, PTRef consequent, SymRef vertex) const {
+    MemoryAccounting::Scope accounted(memory, "implication checks");
     QueryResult qres;
-    if (antecedent == logic.getTerm_false()) {
+    if (SyntacticImplication(logic).isValid(antecedent, consequent)) {
         qres.answer = QueryAnswer::VALID;
         return qres;
     }
+    auto & samples = implicationSamples.getSamples(vertex);
+    if (auto sample = samples.findRefutation(antecedent, consequent)) {
+        qres.answer = QueryAnswer::INVALID;
+        qres.model = std::move(sample);
+        return qres;
+    }
     SMTConfig config;
     MainSolver solver(logic, config, "checker");
     solver.insertFormula(antecedent);
     solver.insertFormula(logic.mkNot(consequent));
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "spacer.implies");
     if (res == s_True) {
         qres.answer = QueryAnswer::INVALID;
         qres.model = solver.getModel();
+        samples.addSample(qres.model);
     }
     else if (res == s_False) {
         qres.answer = QueryAnswer::VALID;
@@ -414,6 +456,7 @@ SpacerContext::QueryResult SpacerContext::implies(PTRef antecedent, PTRef conseq
 }
 
 SpacerContext::ItpQueryResult SpacerContext::interpolatingImplies(PTRef antecedent, PTRef consequent) {
+    MemoryAccounting::Scope accounted(memory, "interpolation");
     SMTConfig config;
     const char* msg = "ok";
     bool set = config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
@@ -422,7 +465,7 @@ SpacerContext::ItpQueryResult SpacerContext::interpolatingImplies(PTRef antecede
     MainSolver solver(logic, config, "checker");
     solver.insertFormula(antecedent);
     solver.insertFormula(logic.mkNot(consequent));
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "spacer.interpolating-implies");
     ItpQueryResult qres;
     if (res == s_True) {
         qres.answer = QueryAnswer::INVALID;
@@ -450,7 +493,7 @@ SpacerContext::ItpQueryResult SpacerContext::interpolatingImplies(PTRef antecede
 
 SpacerContext::MustReachResult SpacerContext::mustReachable(EId eid, PTRef targetConstraint, std::size_t bound) {
     PTRef edgeMustSummary = getEdgeMustSummary(eid, bound);
-    auto implCheckRes = implies(edgeMustSummary, logic.mkNot(targetConstraint));
+    auto implCheckRes = implies(edgeMustSummary, logic.mkNot(targetConstraint), graph.getTarget(eid));
     MustReachResult res;
     if (implCheckRes.answer == SpacerContext::QueryAnswer::INVALID) {
         assert(implCheckRes.model);
@@ -472,7 +515,7 @@ SpacerContext::MustReachResult SpacerContext::mustReachable(EId eid, PTRef targe
 bool SpacerContext::mayReachable(EId eid, PTRef targetConstraint, std::size_t bound) const {
     PTRef maySummary = getEdgeMaySummary(eid, bound);
     if (maySummary == logic.getTerm_false()) { return false; }
-    auto implCheckRes = implies(maySummary, logic.mkNot(targetConstraint));
+    auto implCheckRes = implies(maySummary, logic.mkNot(targetConstraint), graph.getTarget(eid));
     if (implCheckRes.answer != SpacerContext::QueryAnswer::INVALID and implCheckRes.answer != SpacerContext::QueryAnswer::VALID) {
         throw std::logic_error("Spacer: Error in checking implication in mayReachable");
     }
@@ -486,7 +529,7 @@ std::optional<ProofObligation> SpacerContext::computePredecessor(EId eid, ProofO
     assert(not sources.empty());
     if (sources.size() == 1) { // Edge with single source, we only need to check if pob is reachable with over-approximation
         PTRef maySummary = getEdgeMaySummary(eid, sourceBound);
-        auto res = implies(maySummary, logic.mkNot(pob.constraint));
+        auto res = implies(maySummary, logic.mkNot(pob.constraint), pob.vertex);
         if (res.answer == QueryAnswer::INVALID) {
             assert(res.model);
             // When this source is over-approximated and the edge becomes feasible -> extract next proof obligation
@@ -517,7 +560,7 @@ std::optional<ProofObligation> SpacerContext::computePredecessor(EId eid, ProofO
     std::size_t vertexToRefine = 0; // vertex that is the last one to be over-approximated
     while(true) {
         PTRef mixedEdgeSummary = getEdgeMixedSummary(eid, sourceBound, vertexToRefine);
-        auto res = implies(mixedEdgeSummary, logic.mkNot(pob.constraint));
+        auto res = implies(mixedEdgeSummary, logic.mkNot(pob.constraint), pob.vertex);
         if (res.answer == QueryAnswer::INVALID) {
             assert(res.model);
             // When this source is over-approximated and the edge becomes feasible -> extract next proof obligation
@@ -569,27 +612,40 @@ SpacerContext::InductiveCheckResult SpacerContext::isInductive(std::size_t maxLe
 }
 
 bool SpacerContext::tryPushComponents(SymRef vid, std::size_t level, PTRef body) {
+    MemoryAccounting::Scope accounted(memory, "lemma pushing");
     auto maySummaryComponents = over.getComponents(vid, level);
     bool allPushed = true;
     SMTConfig config;
     const char* msg = "ok";
-    config.setOption(SMTConfig::o_produce_models, SMTOption(false), msg);
+    config.setOption(SMTConfig::o_produce_models, SMTOption(true), msg);
     config.setOption(SMTConfig::o_produce_inter, SMTOption(false), msg);
     MainSolver solver(logic, config, "inductive checker");
     solver.insertFormula(body);
+    auto & samples = pushSamples.getSamples(vid);
     for (PTRef component : maySummaryComponents) {
         if (over.has(vid, level + 1, component)) {
             continue;
         }
         PTRef nextStateComponent = VersionManager(logic).baseFormulaToTarget(component);
 //        std::cout << " Checking component " << logic.printTerm(nextStateComponent) << std::endl;
+        if (SyntacticImplication(logic).isValid(body, nextStateComponent)) {
+            addMaySummary(vid, level + 1, component);
+            continue;
+        }
+        if (samples.refutes(body, nextStateComponent)) {
+            allPushed = false;
+            continue;
+        }
         solver.push();
         solver.insertFormula(logic.mkNot(nextStateComponent));
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "spacer.push");
         if (res == s_False) {
             addMaySummary(vid, level + 1, component);
         } else {
             allPushed = false;
+            if (res == s_True) {
+                samples.addSample(solver.getModel());
+            }
         }
         solver.pop();
     }
@@ -600,19 +656,12 @@ bool SpacerContext::tryPushComponents(SymRef vid, std::size_t level, PTRef body)
 
 
 PTRef SpacerContext::projectFormula(PTRef fla, const vec<PTRef> &toVars, Model & model) const {
+    MemoryAccounting::Scope accounted(memory, "model-based projection");
     assert(std::all_of(toVars.begin(), toVars.end(), [this](PTRef var) { return logic.isVar(var); }));
 //    std::cout << "Projecting " << logic.printTerm(fla) << " to variables ";
 //    std::for_each(toVars.begin(), toVars.end(), [&](PTRef var) { std::cout << logic.printTerm(var) << ' '; });
 //    std::cout << std::endl;
-    auto varsInFla = TermUtils(logic).getVars(fla);
-
-    vec<PTRef> toEliminate;
-    for (PTRef var : varsInFla) {
-        auto it = std::find(toVars.begin(), toVars.end(), var);
-        if (it == toVars.end()) {
-            toEliminate.push(var);
-        }
-    }
+    vec<PTRef> toEliminate = FreeVariables::of(logic, fla).minus(VariableSet(toVars)).toVec();
     ModelBasedProjection mbp(logic);
     PTRef res = mbp.project(fla, toEliminate, model);
 //    std::cout << "\nResult is " << logic.printTerm(res) << std::endl;
@@ -752,7 +801,7 @@ void computePremiseInstances(DerivationDatabase::Entry const & databaseEntry, En
         solver.insertFormula(factConstraint);
 //        std::cout << logic.pp(factConstraint) << std::endl;
     }
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "spacer.derivation");
     if (res != s_True) {
         throw std::logic_error("Error in computing derivation!");
     }
@@ -9,13 +9,17 @@
 #include "TransformationUtils.h"
 #include "TransitionSystem.h"
 #include "ModelBasedProjection.h"
+#include "Progress.h"
 #include "QuantifierElimination.h"
+#include "QueryDump.h"
+#include "SyntacticImplication.h"
 #include "graph/GraphTransformations.h"
+#include "Tracing.h"
 #include "transformers/BasicTransformationPipelines.h"
 
-#define TRACE_LEVEL 0
+#define TRACE_LEVEL 1
 
-#define TRACE(l,m) if (TRACE_LEVEL >= l) {std::cout << m << std::endl; }
+#define TRACE(l,m) if (TRACE_LEVEL >= l) { GOLEM_TRACE_INSTANT(m) }
 
 const std::string TPAEngine::TPA = "tpa";
 const std::string TPAEngine::SPLIT_TPA = "split-tpa";
@@ -95,7 +99,7 @@ public:
         solver.reset(new MainSolver(logic, config, "Reachability checker"));
         solver->insertFormula(transition);
         solver->insertFormula(query);
-        lastResult = solver->check();
+        lastResult = QueryDump::check(*solver, "tpa.solver-wrapper");
         if (lastResult == s_False) {
             return ReachabilityResult::UNREACHABLE;
         } else if (lastResult == s_True) {
@@ -162,7 +166,7 @@ public:
         pushed = true;
         solver->insertFormula(query);
         ++allformulasInserted;
-        lastResult = solver->check();
+        lastResult = QueryDump::check(*solver, "tpa.solver-wrapper");
         if (lastResult == s_False) {
             return ReachabilityResult::UNREACHABLE;
         } else if (lastResult == s_True) {
@@ -394,10 +398,17 @@ VerificationAnswer TPABase::solveTransitionSystem(TransitionSystem & system) {
 VerificationAnswer TPABase::solve() {
     unsigned short power = 0;
     while (true) {
+        GOLEM_TRACE_SCOPE_DETAIL("tpa.power", "power " << power);
         auto res = checkPower(power);
+        if (verbosity > 0) {
+            memory.printCheckpoint(std::cout, "power " + std::to_string(power));
+        }
         switch (res) {
             case VerificationAnswer::UNSAFE:
             case VerificationAnswer::SAFE:
+                if (verbosity > 1) {
+                    memory.printSummary(std::cout);
+                }
                 return res;
             case VerificationAnswer::UNKNOWN:
                 ++power;
@@ -424,6 +435,7 @@ VerificationAnswer TPASplit::checkPower(unsigned short power) {
         if (verbose() > 0) {
             std::cout << "; System is safe up to <2^" << power + 1 << " steps" << std::endl;
         }
+        GOLEM_PROGRESS("split-tpa", Progress::powerOfTwo(power + 1) - 1, std::nullopt)
         bool fixedPointReached = checkLessThanFixedPoint(power);
         if (fixedPointReached) {
             return VerificationAnswer::SAFE;
@@ -437,6 +449,7 @@ VerificationAnswer TPASplit::checkPower(unsigned short power) {
         if (verbose() > 0) {
             std::cout << "; System is safe up to 2^" << power + 1 << " steps" << std::endl;
         }
+        GOLEM_PROGRESS("split-tpa", Progress::powerOfTwo(power + 1), std::nullopt)
         bool fixedPointReached = checkExactFixedPoint(power);
         if (fixedPointReached and explanation.power <= power) {
             assert(explanation.invariantType != SafetyExplanation::TransitionInvariantType::NONE);
@@ -459,7 +472,7 @@ TPABase::QueryResult TPABase::reachabilityExactOneStep(PTRef from, PTRef to) {
     PTRef goal = getNextVersion(to);
     PTRef smtQuery = logic.mkAnd({from, transition, goal});
     solver.insertFormula(smtQuery);
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "tpa.exact-one-step");
     if (res == s_True) {
         { // TODO: refactor this out
             auto nextStateVars = getStateVars(1);
@@ -484,7 +497,7 @@ TPABase::QueryResult TPABase::reachabilityExactZeroStep(PTRef from, PTRef to) {
     MainSolver solver(logic, config, "0-step checker");
     PTRef intersection = logic.mkAnd(from, to);
     solver.insertFormula(intersection);
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "tpa.exact-zero-step");
     if (res == s_True) {
         result.result = ReachabilityResult::REACHABLE;
         assert(isPureStateFormula(intersection));
@@ -634,7 +647,7 @@ TPASplit::QueryResult TPASplit::reachabilityQueryLessThan(PTRef from, PTRef to,
         // TODO: assert from and to are current-state formulas
         solver.insertFormula(twoStepTransition);
         solver.insertFormula(logic.mkAnd(from, goal));
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "tpa.less-than");
         if (res == s_False) {
             TRACE(3, "Top level query was unreachable")
             auto itpContext = solver.getInterpolationContext();
@@ -892,7 +905,7 @@ bool TPASplit::verifyLessThanPower(unsigned short power) const {
         logic.mkAnd(previous, getNextVersion(previousExact))
     ));
     solver.insertFormula(logic.mkNot(shiftOnlyNextVars(current)));
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "tpa.verify-power");
     return res == s_False;
 }
 
@@ -913,7 +926,7 @@ bool TPASplit::verifyExactPower(unsigned short power) const {
     // check that previous or previousExact concatenated with previous implies current
     solver.insertFormula(logic.mkAnd(previous, getNextVersion(previous)));
     solver.insertFormula(logic.mkNot(shiftOnlyNextVars(current)));
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "tpa.verify-power");
     return res == s_False;
 }
 
@@ -926,13 +939,21 @@ bool TPABase::checkLessThanFixedPoint(unsigned short power) {
         SMTConfig config;
         {
             MainSolver solver(logic, config, "Fixed-point checker");
-            solver.insertFormula(logic.mkAnd({currentLevelTransition, getNextVersion(transition), logic.mkNot(shiftOnlyNextVars(currentLevelTransition))}));
-            auto satres = solver.check();
+            PTRef antecedent = logic.mkAnd(currentLevelTransition, getNextVersion(transition));
+            PTRef consequent = shiftOnlyNextVars(currentLevelTransition);
+            solver.insertFormula(logic.mkAnd(antecedent, logic.mkNot(consequent)));
+            sstat satres = s_True;
+            if (SyntacticImplication(logic).isValid(antecedent, consequent)) {
+                satres = s_False;
+            } else if (not rightFixedPointSamples.refutes(antecedent, consequent)) {
+                satres = QueryDump::check(solver, "tpa.fixed-point");
+                if (satres == s_True) { rightFixedPointSamples.addSample(solver.getModel()); }
+            }
             bool restrictedInvariant = false;
             if (satres != s_False) {
                 solver.push();
                 solver.insertFormula(init);
-                satres = solver.check();
+                satres = QueryDump::check(solver, "tpa.fixed-point");
                 if (satres == s_False) {
                     restrictedInvariant = true;
                 }
@@ -952,13 +973,21 @@ bool TPABase::checkLessThanFixedPoint(unsigned short power) {
         // now check if it is fixed point with respect to bad states
         {
             MainSolver solver(logic, config, "Fixed-point checker");
-            solver.insertFormula(logic.mkAnd({transition, getNextVersion(currentLevelTransition), logic.mkNot(shiftOnlyNextVars(currentLevelTransition))}));
-            auto satres = solver.check();
+            PTRef antecedent = logic.mkAnd(transition, getNextVersion(currentLevelTransition));
+            PTRef consequent = shiftOnlyNextVars(currentLevelTransition);
+            solver.insertFormula(logic.mkAnd(antecedent, logic.mkNot(consequent)));
+            sstat satres = s_True;
+            if (SyntacticImplication(logic).isValid(antecedent, consequent)) {
+                satres = s_False;
+            } else if (not leftFixedPointSamples.refutes(antecedent, consequent)) {
+                satres = QueryDump::check(solver, "tpa.fixed-point");
+                if (satres == s_True) { leftFixedPointSamples.addSample(solver.getModel()); }
+            }
             bool restrictedInvariant = false;
             if (satres != s_False) {
                 solver.push();
                 solver.insertFormula(getNextVersion(query, 2));
-                satres = solver.check();
+                satres = QueryDump::check(solver, "tpa.fixed-point");
                 if (satres == s_False) {
                     restrictedInvariant = true;
                 }
@@ -988,12 +1017,12 @@ bool TPASplit::checkExactFixedPoint(unsigned short power) {
         SMTConfig config;
         MainSolver solver(logic, config, "Fixed-point checker");
         solver.insertFormula(logic.mkAnd({currentTwoStep, logic.mkNot(shifted)}));
-        sstat satres = solver.check();
+        sstat satres = QueryDump::check(solver, "tpa.fixed-point");
         char restrictedInvariant = 0;
         if (satres != s_False) {
             solver.push();
             solver.insertFormula(getNextVersion(logic.mkAnd(init, getLessThanPower(i)), -1));
-            satres = solver.check();
+            satres = QueryDump::check(solver, "tpa.fixed-point");
             if (satres == s_False) {
                 restrictedInvariant = 1;
             }
@@ -1002,7 +1031,7 @@ bool TPASplit::checkExactFixedPoint(unsigned short power) {
             solver.pop();
             solver.push();
             solver.insertFormula(logic.mkAnd(getNextVersion(getLessThanPower(i), 2), getNextVersion(query, 3)));
-            satres = solver.check();
+            satres = QueryDump::check(solver, "tpa.fixed-point");
             if (satres == s_False) {
                 restrictedInvariant = 2;
             }
@@ -1048,7 +1077,7 @@ bool TPABase::verifyKinductiveInvariant(PTRef fla, unsigned long k) const {
             solver.insertFormula(getNextVersion(transition, i));
         }
         solver.insertFormula(logic.mkNot(getNextVersion(fla, k)));
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "tpa.k-induction");
         if (res != s_False) {
             std::cerr << "k-induction verification failed; induction step does not hold!" << std::endl;
             return false;
@@ -1062,7 +1091,7 @@ bool TPABase::verifyKinductiveInvariant(PTRef fla, unsigned long k) const {
         for (unsigned long i = 0; i < k; ++i) {
             solver.push();
             solver.insertFormula(logic.mkNot(getNextVersion(fla, i)));
-            auto res = solver.check();
+            auto res = QueryDump::check(solver, "tpa.k-induction");
             if (res != s_False) {
                 std::cerr << "k-induction verification failed; base case " << i << " does not hold!" << std::endl;
                 return false;
@@ -1126,6 +1155,7 @@ VerificationAnswer TPABasic::checkPower(unsigned short power) {
         if (verbose() > 0) {
             std::cout << "; System is safe up to <=2^" << power + 1 << " steps" << std::endl;
         }
+        GOLEM_PROGRESS("tpa", Progress::powerOfTwo(power + 1), std::nullopt)
         // Check if we have not reached fixed point.
         bool fixedPointReached = checkLessThanFixedPoint(power);
         if (fixedPointReached) {
@@ -1254,7 +1284,7 @@ bool TPABasic::verifyPower(unsigned short level) const {
     solver.insertFormula(logic.mkAnd(previous, getNextVersion(previous)));
     solver.insertFormula(logic.mkNot(shiftOnlyNextVars(current)));
     solver.insertFormula(logic.mkNot(shiftOnlyNextVars(current)));
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "tpa.verify-power");
     return res == s_False;
 }
 
@@ -1269,7 +1299,7 @@ PTRef TPABase::safeSupersetOfInitialStates(PTRef start, PTRef transitionInvarian
     solver.insertFormula(start);
     solver.insertFormula(transitionInvariant);
     solver.insertFormula(target);
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "tpa.safe-init");
     if (res != s_False) {
         throw std::logic_error("SMT query was suppose to be unsat, but is not!");
     }
@@ -1500,7 +1530,7 @@ TransitionSystemNetworkManager::QueryResult TransitionSystemNetworkManager::quer
     solver.insertFormula(sourceCondition);
     solver.insertFormula(label);
     solver.insertFormula(target);
-    auto res = solver.check();
+    auto res = QueryDump::check(solver, "tpa.network");
     if (res == s_True) {
         auto model = solver.getModel();
         ModelBasedProjection mbp(logic);
@@ -8,6 +8,8 @@
 #define GOLEM_TPA_H
 
 #include "Engine.h"
+#include "MemoryAccounting.h"
+#include "SampleStore.h"
 
 class TransitionSystem;
 
@@ -98,9 +100,16 @@ protected:
 
     PTRef identity {PTRef_Undef};
 
+    // Counterexamples to the fixed-point checks, (T^{<=n} . T => T^{<=n}) and (T . T^{<=n} => T^{<=n}) respectively
+    SampleSet rightFixedPointSamples;
+    SampleSet leftFixedPointSamples;
+
+    // Growth of the term store per power level
+    MemoryAccounting memory;
+
 public:
 
-    TPABase(Logic& logic, Options const & options) : logic(logic), options(options) {
+    TPABase(Logic& logic, Options const & options) : logic(logic), options(options), rightFixedPointSamples(logic), leftFixedPointSamples(logic), memory(logic, "TPA") {
         if (options.hasOption(Options::VERBOSE)) {
             verbosity = std::stoi(options.getOption(Options::VERBOSE));
         }
@@ -56,8 +56,8 @@ std::vector<SymRef> postOrder(ChcDirectedGraph const & graph, AdjacencyListsGrap
 }
 
 bool ChcDirectedHyperGraph::isNormalGraph() const {
-    return std::all_of(edges.begin(), edges.end(), [](auto const & entry) {
-        auto const & sources = entry.second.from;
+    return std::all_of(edges.begin(), edges.end(), [](auto const & edge) {
+        auto const & sources = edge.from;
         assert(not sources.empty());
         return sources.size() == 1;
     });
@@ -129,17 +129,8 @@ void ChcDirectedGraph::toDot(std::ostream & out, bool full) const {
 }
 
 DirectedEdge ChcDirectedGraph::reverseEdge(DirectedEdge const & edge, TermUtils & utils) const {
-    auto rfrom = edge.to;
-    auto rto = edge.from;
-    PTRef ofla = edge.fla.fla;
-    std::unordered_map<PTRef, PTRef, PTRefHash> subst;
-    // variables from 'from' are expressed as state vars, they must be changed to next state
-    utils.mapFromPredicate(this->getStateVersion(edge.from), this->getNextStateVersion(edge.from), subst);
-    // variables from 'to' are expressed as next state vars, they must be changed to state
-    utils.mapFromPredicate(this->getNextStateVersion(edge.to), this->getStateVersion(edge.to), subst);
-    // simulataneous substitution
-    PTRef rfla = utils.varSubstitute(ofla, subst);
-    return DirectedEdge{.from = rfrom, .to = rto, .fla = InterpretedFla{rfla}, .id = edge.id};
+    PTRef rfla = reverseEdgeLabel(*this, edge.fla.fla, edge.from, edge.to, utils);
+    return DirectedEdge{.from = edge.to, .to = edge.from, .fla = InterpretedFla{rfla}, .id = edge.id};
 }
 
 ChcDirectedGraph ChcDirectedGraph::reverse() const {
@@ -147,14 +138,10 @@ ChcDirectedGraph ChcDirectedGraph::reverse() const {
     // NOTE: reversing edge means flipping state and next state variables
     TermUtils utils(logic);
     std::vector<DirectedEdge> redges;
-    auto swapTrueFalse = [&](SymRef sym) {
-        return sym == logic.getSym_false() ? logic.getSym_true()
-            : sym == logic.getSym_true() ? logic.getSym_false() : sym;
-    };
     forEachEdge([&](auto const & edge) {
         auto reversed = reverseEdge(edge, utils);
-        swapTrueFalse(reversed.from);
-        swapTrueFalse(reversed.to);
+        reversed.from = swapEntryAndExit(reversed.from, logic);
+        reversed.to = swapEntryAndExit(reversed.to, logic);
         redges.push_back(reversed);
     });
     return ChcDirectedGraph(std::move(redges), this->predicates, logic);
@@ -10,10 +10,14 @@
 #include "ChcSystem.h"
 #include "TermUtils.h"
 
+#include <cassert>
+#include <deque>
 #include <iosfwd>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 
 struct VId {
     std::size_t id;
@@ -51,6 +55,92 @@ struct DirectedEdge {
     EId id;
 };
 
+/*
+ * Edges of a graph indexed directly by their ids.
+ * Ids are handed out consecutively and never reused, so the slot of an edge is its id. Removed edges leave an empty
+ * slot behind (tombstone). A deque keeps references to edges valid when new edges are added, as with a node-based map.
+ * Iteration visits the live edges in the order of their ids.
+ */
+template<typename TEdge>
+class EdgeStore {
+    std::deque<std::optional<TEdge>> slots;
+    std::size_t liveCount = 0;
+
+    template<typename TSlotIt, typename TValue>
+    class Iterator {
+        TSlotIt current;
+        TSlotIt last;
+
+        void skipTombstones() {
+            while (current != last and not current->has_value()) { ++current; }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = TEdge;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TValue *;
+        using reference = TValue &;
+
+        Iterator(TSlotIt current, TSlotIt last) : current(current), last(last) { skipTombstones(); }
+
+        reference operator*() const { return current->value(); }
+        pointer operator->() const { return &current->value(); }
+        Iterator & operator++() { ++current; skipTombstones(); return *this; }
+        Iterator operator++(int) { Iterator copy = *this; ++(*this); return copy; }
+        bool operator==(Iterator const & other) const { return current == other.current; }
+        bool operator!=(Iterator const & other) const { return current != other.current; }
+    };
+
+public:
+    using iterator = Iterator<typename std::deque<std::optional<TEdge>>::iterator, TEdge>;
+    using const_iterator = Iterator<typename std::deque<std::optional<TEdge>>::const_iterator, TEdge const>;
+
+    void emplace(EId eid, TEdge edge) {
+        if (eid.id >= slots.size()) { slots.resize(eid.id + 1); }
+        if (slots[eid.id].has_value()) { throw std::logic_error("Edge with the same id is already present"); }
+        slots[eid.id].emplace(std::move(edge));
+        ++liveCount;
+    }
+
+    bool contains(EId eid) const { return eid.id < slots.size() and slots[eid.id].has_value(); }
+
+    TEdge const & at(EId eid) const {
+        if (not contains(eid)) { throw std::out_of_range("Unknown edge"); }
+        return slots[eid.id].value();
+    }
+
+    TEdge & operator[](EId eid) {
+        assert(contains(eid));
+        return slots[eid.id].value();
+    }
+
+    void erase(EId eid) {
+        if (contains(eid)) {
+            slots[eid.id].reset();
+            --liveCount;
+        }
+    }
+
+    template<typename TPred>
+    void eraseIf(TPred predicate) {
+        for (auto & slot : slots) {
+            if (slot.has_value() and predicate(slot.value())) {
+                slot.reset();
+                --liveCount;
+            }
+        }
+    }
+
+    std::size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+
+    iterator begin() { return iterator(slots.begin(), slots.end()); }
+    iterator end() { return iterator(slots.end(), slots.end()); }
+    const_iterator begin() const { return const_iterator(slots.cbegin(), slots.cend()); }
+    const_iterator end() const { return const_iterator(slots.cend(), slots.cend()); }
+};
+
 class ChcDirectedGraph;
 class ChcDirectedHyperGraph;
 
@@ -113,7 +203,7 @@ struct VertexHasher {
 };
 
 class ChcDirectedGraph {
-    std::map<EId, DirectedEdge> edges;
+    EdgeStore<DirectedEdge> edges;
     LinearCanonicalPredicateRepresentation predicates;
     Logic & logic;
     mutable std::size_t freeId {0};
@@ -170,7 +260,7 @@ public:
     template<typename TAction>
     void forEachEdge(TAction action) const {
         for (auto const & edge : edges) {
-            action(edge.second);
+            action(edge);
         }
     }
 
@@ -181,13 +271,7 @@ private:
 
     template<typename TPred>
     void deleteMatchingEdges(TPred predicate) {
-        for (auto it = edges.cbegin(); it != edges.cend(); /* no increment */) {
-            if (predicate(it->second)) {
-                it = edges.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        edges.eraseIf(predicate);
     }
 
     EId freshId() const { return EId{freeId++};}
@@ -201,7 +285,7 @@ private:
 
 
 class ChcDirectedHyperGraph {
-    std::map<EId, DirectedHyperEdge> edges;
+    EdgeStore<DirectedHyperEdge> edges;
     NonlinearCanonicalPredicateRepresentation predicates;
     Logic & logic;
     mutable std::size_t freeId {0};
@@ -267,8 +351,8 @@ public:
 
     template<typename TAction>
     void forEachEdge(TAction action) const {
-        for (auto const & entry : edges) {
-            action(entry.second);
+        for (auto const & edge : edges) {
+            action(edge);
         }
     }
 
@@ -284,19 +368,30 @@ private:
 
     template<typename TPred>
     void deleteMatchingEdges(TPred predicate) {
-        for (auto it = edges.cbegin(); it != edges.cend(); /* no increment */) {
-            if (predicate(it->second)) {
-                it = edges.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        edges.eraseIf(predicate);
     }
 
     DirectedHyperEdge mergeEdges(std::vector<EId> const & chain);
     PTRef mergeLabels(std::vector<EId> const & chain);
 };
 
+// Entry (true) and exit (false) exchange their roles when a graph is reversed
+inline SymRef swapEntryAndExit(SymRef sym, Logic & logic) {
+    return sym == logic.getSym_false() ? logic.getSym_true() : sym == logic.getSym_true() ? logic.getSym_false() : sym;
+}
+
+// Label of an edge from source to target read in the opposite direction: state and next-state variables are exchanged
+template<typename TGraph>
+PTRef reverseEdgeLabel(TGraph const & graph, PTRef label, SymRef source, SymRef target, TermUtils & utils) {
+    TermUtils::substitutions_map subst;
+    // variables from 'source' are expressed as state vars, they must be changed to next state
+    utils.mapFromPredicate(graph.getStateVersion(source), graph.getNextStateVersion(source), subst);
+    // variables from 'target' are expressed as next state vars, they must be changed to state
+    utils.mapFromPredicate(graph.getNextStateVersion(target), graph.getStateVersion(target), subst);
+    // simulataneous substitution
+    return utils.varSubstitute(label, subst);
+}
+
 std::optional<EId> getSelfLoopFor(SymRef, ChcDirectedGraph const & graph, AdjacencyListsGraphRepresentation const & adjacencyRepresentation);
 
 std::vector<SymRef> reversePostOrder(ChcDirectedGraph const & graph, AdjacencyListsGraphRepresentation const & adjacencyRepresentation);
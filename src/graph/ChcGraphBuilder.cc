@@ -10,6 +10,7 @@ std::unique_ptr<ChcDirectedHyperGraph> ChcGraphBuilder::buildGraph(NormalizedChc
     std::vector<DirectedHyperEdge> edges;
 
     ChcSystem const & chcSystem = *system.normalizedSystem;
+    edges.reserve(chcSystem.getClauses().size());
     // Special case to cover initial clauses, we are adding artificial "TRUE" starting predicate
     SymRef init = logic.getSym_true();
     for (auto const & clause : chcSystem.getClauses()) {
@@ -18,6 +19,7 @@ std::unique_ptr<ChcDirectedHyperGraph> ChcGraphBuilder::buildGraph(NormalizedChc
         auto headSymbol = logic.getSymRef(head.predicate.predicate);
 
         std::vector<SymRef> from;
+        from.reserve(std::max<std::size_t>(body.uninterpretedPart.size(), 1));
         for (auto const& bodyPredicate : body.uninterpretedPart) {
             from.push_back(logic.getSymRef(bodyPredicate.predicate));
         }
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "LargeBlockEncoding.h"
+
+#include "QuantifierElimination.h"
+
+#include <algorithm>
+
+LargeBlockEncoding::LargeBlockEncoding(Logic & logic, ChcDirectedGraph const & graph) : logic(logic), original(graph) {
+    auto adjacency = AdjacencyListsGraphRepresentation::from(graph);
+    auto order = reversePostOrder(graph, adjacency);
+    std::unordered_map<SymRef, std::size_t, SymRefHash> position;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        position.insert({order[i], i});
+    }
+    // Every cycle contains a back edge, so removing the targets of back edges leaves only DAG regions
+    std::unordered_set<SymRef, SymRefHash> cutpoints{graph.getEntry(), graph.getExit()};
+    graph.forEachEdge([&](DirectedEdge const & edge) {
+        auto sourceIt = position.find(edge.from);
+        if (sourceIt == position.end()) { return; } // unreachable edge
+        if (position.at(edge.to) <= sourceIt->second) {
+            cutpoints.insert(edge.to);
+        }
+    });
+    for (SymRef vertex : order) {
+        if (cutpoints.count(vertex) > 0) {
+            buildRegion(vertex, order, cutpoints, adjacency);
+        }
+    }
+    // NOTE: The block graph assigns edge ids in the order of the edges, so the block with index i gets EId i
+    std::vector<DirectedEdge> blockEdges;
+    for (auto const & block : blocks) {
+        vec<PTRef> paths;
+        for (auto const & choice : block.lastSteps) {
+            paths.push(choice.fla);
+        }
+        blockEdges.push_back(DirectedEdge{.from = block.source, .to = block.target, .fla = {logic.mkOr(std::move(paths))}, .id = {0}});
+    }
+    blockGraph = std::make_unique<ChcDirectedGraph>(std::move(blockEdges), graph.getPredicateRepresentation(), logic);
+}
+
+void LargeBlockEncoding::buildRegion(SymRef cutpoint, std::vector<SymRef> const & order,
+                                     std::unordered_set<SymRef, SymRefHash> const & cutpoints,
+                                     AdjacencyListsGraphRepresentation const & adjacency) {
+    TermUtils utils(logic);
+    Region region;
+    auto inRegion = [&](SymRef vertex) { return vertex == cutpoint or region.reachability.count(vertex) > 0; };
+    auto guard = [&](SymRef vertex) { return vertex == cutpoint ? logic.getTerm_true() : region.reachability.at(vertex); };
+    // Edges inside the region are forward edges, so reverse post-order is a topological order of the region
+    auto start = std::find(order.begin(), order.end(), cutpoint);
+    assert(start != order.end());
+    for (auto it = start + 1; it != order.end(); ++it) {
+        SymRef vertex = *it;
+        if (cutpoints.count(vertex) > 0) { continue; }
+        // Intermediate vertices keep their variables in the state version
+        TermUtils::substitutions_map subst;
+        utils.mapFromPredicate(original.getNextStateVersion(vertex), original.getStateVersion(vertex), subst);
+        Choices choices;
+        vec<PTRef> paths;
+        for (EId incoming : adjacency.getIncomingEdgesFor(vertex)) {
+            SymRef source = original.getSource(incoming);
+            if (not inRegion(source)) { continue; }
+            PTRef fla = logic.mkAnd(guard(source), utils.varSubstitute(original.getEdgeLabel(incoming), subst));
+            choices.push_back(Choice{incoming, source, fla});
+            paths.push(fla);
+        }
+        if (choices.empty()) { continue; }
+        region.vertices.push_back(vertex);
+        region.reachability.insert({vertex, logic.mkOr(std::move(paths))});
+        region.reachedVia.insert({vertex, std::move(choices)});
+    }
+    // Edges from the region to cutpoints are grouped into one block per target
+    std::unordered_map<SymRef, std::size_t, SymRefHash> blockFor;
+    auto addRegionExits = [&](SymRef vertex) {
+        for (EId outgoing : adjacency.getOutgoingEdgesFor(vertex)) {
+            SymRef target = original.getTarget(outgoing);
+            if (cutpoints.count(target) == 0) { continue; }
+            auto it = blockFor.find(target);
+            if (it == blockFor.end()) {
+                it = blockFor.insert({target, blocks.size()}).first;
+                blocks.push_back(Block{cutpoint, target, {}});
+            }
+            PTRef fla = logic.mkAnd(guard(vertex), original.getEdgeLabel(outgoing));
+            blocks[it->second].lastSteps.push_back(Choice{outgoing, vertex, fla});
+        }
+    };
+    addRegionExits(cutpoint);
+    for (SymRef vertex : region.vertices) {
+        addRegionExits(vertex);
+    }
+    regions.insert({cutpoint, std::move(region)});
+}
+
+std::vector<EId> LargeBlockEncoding::expandPath(std::vector<EId> const & blockPath, Model & model) const {
+    TimeMachine timeMachine(logic);
+    std::vector<EId> originalPath;
+    for (std::size_t step = 0; step < blockPath.size(); ++step) {
+        assert(blockPath[step].id < blocks.size());
+        Block const & block = blocks[blockPath[step].id];
+        assert(blockGraph->getSource(blockPath[step]) == block.source);
+        auto taken = [&](Choices const & choices) -> Choice const & {
+            auto it = std::find_if(choices.begin(), choices.end(), [&](Choice const & choice) {
+                return model.evaluate(timeMachine.sendFlaThroughTime(choice.fla, static_cast<int>(step))) == logic.getTerm_true();
+            });
+            if (it == choices.end()) {
+                throw std::logic_error("LargeBlockEncoding: No path through the block is satisfied by the model!");
+            }
+            return *it;
+        };
+        // Walk backwards from the target of the block to its source
+        Region const & region = regions.at(block.source);
+        std::vector<EId> segment;
+        Choice const * choice = &taken(block.lastSteps);
+        segment.push_back(choice->edge);
+        while (choice->source != block.source) {
+            choice = &taken(region.reachedVia.at(choice->source));
+            segment.push_back(choice->edge);
+        }
+        originalPath.insert(originalPath.end(), segment.rbegin(), segment.rend());
+    }
+    return originalPath;
+}
+
+std::unordered_map<PTRef, PTRef, PTRefHash> LargeBlockEncoding::extendSolution(std::unordered_map<PTRef, PTRef, PTRefHash> solution) const {
+    TermUtils utils(logic);
+    // Interpretation of an intermediate vertex is the strongest postcondition of the interpretations of the cutpoints
+    std::unordered_map<SymRef, std::vector<PTRef>, SymRefHash> reachedStates;
+    auto interpretationOf = [&](SymRef cutpoint) {
+        if (cutpoint == original.getEntry()) { return logic.getTerm_true(); }
+        auto it = solution.find(original.getStateVersion(cutpoint));
+        return it == solution.end() ? logic.getTerm_false() : it->second;
+    };
+    for (auto const & [cutpoint, region] : regions) {
+        if (region.vertices.empty()) { continue; }
+        PTRef cutpointStates = interpretationOf(cutpoint);
+        if (cutpointStates == logic.getTerm_false()) { continue; }
+        for (SymRef vertex : region.vertices) {
+            vec<PTRef> stateVars;
+            for (PTRef var : utils.predicateArgsInOrder(original.getStateVersion(vertex))) {
+                stateVars.push(var);
+            }
+            PTRef states = logic.mkAnd(cutpointStates, region.reachability.at(vertex));
+            reachedStates[vertex].push_back(QuantifierElimination(logic).keepOnly(states, stateVars));
+        }
+    }
+    for (SymRef vertex : original.getVertices()) {
+        PTRef predicate = original.getStateVersion(vertex);
+        if (logic.isTrue(predicate) or logic.isFalse(predicate) or solution.count(predicate) > 0) { continue; }
+        auto it = reachedStates.find(vertex);
+        solution.insert({predicate, it == reachedStates.end() ? logic.getTerm_false() : logic.mkOr(it->second)});
+    }
+    return solution;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_LARGEBLOCKENCODING_H
+#define GOLEM_LARGEBLOCKENCODING_H
+
+#include "ChcGraph.h"
+
+#include "osmt_solver.h"
+
+/*
+ * Large-block encoding of a linear CHC graph
+ *
+ * Cutpoints are the entry, the exit and the targets of back edges (loop heads) of a DFS from the entry.
+ * Every loop-free region between cutpoints is collapsed into a single edge per pair of cutpoints, labeled with
+ * the disjunction of all paths through the region. Paths are not enumerated, the label is built over the region's DAG
+ * with each intermediate vertex keeping its own (state) variables, so its size is linear in the size of the region.
+ *
+ * Vertices not reachable from the entry are dropped from the block graph.
+ * Paths in the block graph can be expanded back to paths in the original graph given a model of the path formula,
+ * and solutions of the block graph can be extended to solutions of the original graph.
+ */
+class LargeBlockEncoding {
+    struct Choice {
+        EId edge;
+        SymRef source;
+        PTRef fla;
+    };
+    using Choices = std::vector<Choice>;
+
+    struct Region {
+        // Intermediate vertices reachable from the cutpoint, in topological order
+        std::vector<SymRef> vertices;
+        std::unordered_map<SymRef, Choices, SymRefHash> reachedVia;
+        std::unordered_map<SymRef, PTRef, SymRefHash> reachability;
+    };
+
+    struct Block {
+        SymRef source;
+        SymRef target;
+        Choices lastSteps;
+    };
+
+    Logic & logic;
+    ChcDirectedGraph const & original;
+    std::unordered_map<SymRef, Region, SymRefHash> regions;
+    std::vector<Block> blocks;
+    std::unique_ptr<ChcDirectedGraph> blockGraph;
+
+    void buildRegion(SymRef cutpoint, std::vector<SymRef> const & order,
+                     std::unordered_set<SymRef, SymRefHash> const & cutpoints,
+                     AdjacencyListsGraphRepresentation const & adjacency);
+
+public:
+    LargeBlockEncoding(Logic & logic, ChcDirectedGraph const & graph);
+
+    ChcDirectedGraph const & getOriginalGraph() const { return original; }
+
+    ChcDirectedGraph const & getBlockGraph() const { return *blockGraph; }
+
+    /*
+     * Expands a path of block edges to the path of original edges taken in the given model.
+     * The model must satisfy the path formula where the label of the i-th block is sent i steps through time.
+     */
+    std::vector<EId> expandPath(std::vector<EId> const & blockPath, Model & model) const;
+
+    // Extends a solution of the block graph with interpretations of the vertices eliminated by the encoding
+    std::unordered_map<PTRef, PTRef, PTRefHash> extendSolution(std::unordered_map<PTRef, PTRef, PTRefHash> solution) const;
+};
+
+
+#endif //GOLEM_LARGEBLOCKENCODING_H
@@ -7,8 +7,10 @@
 
 #ifdef OPENSMT_LOCAL_BUILD
 #include "smt2newcontext.h"
+#include "Interpret.h"
 #else
 #include "opensmt/smt2newcontext.h"
+#include "opensmt/Interpret.h"
 #endif // OPENSMT_LOCAL_BUILD
 
 #endif //GOLEM_OSMT_PARSER_H
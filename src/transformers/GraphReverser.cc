@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "GraphReverser.h"
+
+Transformer::TransformationResult GraphReverser::transform(std::unique_ptr<ChcDirectedHyperGraph> graph) {
+    if (not graph->isNormalGraph()) {
+        throw std::logic_error("Only linear CHC systems can be solved in the backward direction");
+    }
+    Logic & logic = graph->getLogic();
+    TermUtils utils(logic);
+    std::vector<DirectedHyperEdge> reversedEdges;
+    std::vector<EId> edgeIds;
+    graph->forEachEdge([&](DirectedHyperEdge const & edge) {
+        SymRef source = edge.from.front();
+        PTRef reversedLabel = reverseEdgeLabel(*graph, edge.fla.fla, source, edge.to, utils);
+        reversedEdges.push_back(DirectedHyperEdge{
+            .from = {swapEntryAndExit(edge.to, logic)}, .to = swapEntryAndExit(source, logic),
+            .fla = InterpretedFla{reversedLabel}, .id = edge.id
+        });
+        edgeIds.push_back(edge.id);
+    });
+    auto reversed = std::make_unique<ChcDirectedHyperGraph>(std::move(reversedEdges), graph->predicateRepresentation(), logic);
+    // The reversed graph numbers the edges in the order in which they were given
+    std::unordered_map<std::size_t, EId> originalEdges;
+    std::size_t index = 0;
+    reversed->forEachEdge([&](DirectedHyperEdge const & edge) {
+        originalEdges.insert({edge.id.id, edgeIds[index++]});
+    });
+    return {std::move(reversed), std::make_unique<BackTranslator>(logic, std::move(originalEdges))};
+}
+
+InvalidityWitness GraphReverser::BackTranslator::translate(InvalidityWitness witness) {
+    auto const & derivation = witness.getDerivation();
+    if (derivation.size() == 0) { return witness; }
+    // Linear derivation: true, facts derived along the reversed error path, false
+    using DerivationStep = InvalidityWitness::Derivation::DerivationStep;
+    std::vector<DerivationStep> steps;
+    steps.push_back(derivation[0]);
+    std::size_t const last = derivation.size() - 1;
+    for (std::size_t i = 1; i <= last; ++i) {
+        // Original step i derives the fact of reversed step (last - i) using the edge of reversed step (last - i + 1)
+        DerivationStep step;
+        step.index = i;
+        step.premises = {i - 1};
+        step.derivedFact = i == last ? logic.getTerm_false() : derivation[last - i].derivedFact;
+        auto it = originalEdges.find(derivation[last - i + 1].clauseId.id);
+        if (it == originalEdges.end()) { return InvalidityWitness(); }
+        step.clauseId = it->second;
+        steps.push_back(std::move(step));
+    }
+    InvalidityWitness translated;
+    translated.setDerivation(InvalidityWitness::Derivation(std::move(steps)));
+    return translated;
+}
+
+ValidityWitness GraphReverser::BackTranslator::translate(ValidityWitness witness) {
+    auto definitions = witness.getDefinitions();
+    for (auto & [predicate, definition] : definitions) {
+        if (predicate == logic.getTerm_true() or predicate == logic.getTerm_false()) { continue; }
+        definition = logic.mkNot(definition);
+    }
+    return ValidityWitness(std::move(definitions));
+}
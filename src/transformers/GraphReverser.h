@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_GRAPHREVERSER_H
+#define GOLEM_GRAPHREVERSER_H
+
+#include "Transformer.h"
+
+/*
+ * Reverses a linear CHC graph: every edge is flipped (state and next-state variables are swapped) and the roles of
+ * the entry and the exit are exchanged. Any engine run on the reversed graph thus searches backward from the bad states.
+ *
+ * A solution of the reversed system over-approximates the states that can reach the bad states; its negation is a
+ * solution of the original system. An error path in the reversed graph is the original error path read backward.
+ */
+class GraphReverser : public Transformer {
+public:
+    TransformationResult transform(std::unique_ptr<ChcDirectedHyperGraph> graph) override;
+
+    class BackTranslator : public WitnessBackTranslator {
+        Logic & logic;
+        // Ids of the original edges, indexed by the ids of the reversed edges
+        std::unordered_map<std::size_t, EId> originalEdges;
+
+    public:
+        BackTranslator(Logic & logic, std::unordered_map<std::size_t, EId> originalEdges) :
+            logic(logic), originalEdges(std::move(originalEdges)) {}
+
+        InvalidityWitness translate(InvalidityWitness witness) override;
+        ValidityWitness translate(ValidityWitness witness) override;
+    };
+};
+
+
+#endif //GOLEM_GRAPHREVERSER_H
@@ -6,9 +6,11 @@
 
 #include "NonLoopEliminator.h"
 
+#include "QueryDump.h"
+
 void NonLoopEliminator::BackTranslator::notifyRemovedVertex(SymRef sym, Entry edges) {
-    assert(removedNodes.count(sym) == 0);
-    removedNodes.insert({sym, std::move(edges)});
+    assert(std::none_of(removedNodes.begin(), removedNodes.end(), [sym](auto const & entry) { return entry.first == sym; }));
+    removedNodes.emplace_back(sym, std::move(edges));
 }
 
 Transformer::TransformationResult NonLoopEliminator::transform(std::unique_ptr<ChcDirectedHyperGraph> graph) {
@@ -49,18 +51,27 @@ InvalidityWitness NonLoopEliminator::BackTranslator::translate(InvalidityWitness
 ValidityWitness NonLoopEliminator::BackTranslator::translate(ValidityWitness witness) {
     if (this->removedNodes.empty()) { return witness; }
     auto definitions = witness.getDefinitions();
+    // Index of the definitions by predicate symbol, kept in sync with newly computed definitions
+    std::unordered_map<SymRef, PTRef, SymRefHash> definitionsBySymbol;
+    for (auto const & [predicate, definition] : definitions) {
+        definitionsBySymbol.insert({logic.getSymRef(predicate), definition});
+    }
 
     auto definitionFor = [&](SymRef vertex) {
         if (vertex == logic.getSym_false()) { return logic.getTerm_false(); }
         if (vertex == logic.getSym_true()) { return logic.getTerm_true(); }
-        auto it = std::find_if(definitions.begin(), definitions.end(), [&](auto const & entry){
-            return logic.getSymRef(entry.first) == vertex;
-        });
-        return it != definitions.end() ? it->second : PTRef_Undef;
+        auto it = definitionsBySymbol.find(vertex);
+        return it != definitionsBySymbol.end() ? it->second : PTRef_Undef;
     };
     VersionManager manager(logic);
     TermUtils utils(logic);
-    for (auto && [vertex, entry] : this->removedNodes) {
+    SMTConfig config;
+    const char * msg;
+    config.setOption(SMTConfig::o_produce_models, SMTOption(false), msg);
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    // Vertices removed later are neighbours of those removed earlier, so their definitions must be computed first
+    for (auto it = removedNodes.rbegin(); it != removedNodes.rend(); ++it) {
+        auto const & [vertex, entry] = *it;
         vec<PTRef> incomingFormulas;
         for (auto const & edge : entry.incoming) {
             if (edge.from.size() != 1) { throw std::logic_error("NonLoopEliminator should not have processed hyperEdges!"); }
@@ -88,14 +99,10 @@ ValidityWitness NonLoopEliminator::BackTranslator::translate(ValidityWitness wit
         PTRef incomingPart = logic.mkOr(std::move(incomingFormulas));
         PTRef outgoingPart = logic.mkOr(std::move(outgoingFormulas));
         outgoingPart = utils.varSubstitute(outgoingPart, substitutionsMap);
-        SMTConfig config;
-        const char * msg;
-        config.setOption(SMTConfig::o_produce_models, SMTOption(false), msg);
-        config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
         MainSolver solver(logic, config, "solver");
         solver.insertFormula(incomingPart);
         solver.insertFormula(outgoingPart);
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "nonloop.validity");
         if (res != s_False) {
             throw std::logic_error("Error in backtranslating of nonloops elimination");
         }
@@ -107,6 +114,7 @@ ValidityWitness NonLoopEliminator::BackTranslator::translate(ValidityWitness wit
         PTRef predicate = manager.sourceFormulaToBase(predicateRepresentation.getSourceTermFor(vertex));
         assert(definitions.count(predicate) == 0);
         definitions.insert({predicate, vertexSolution});
+        definitionsBySymbol.insert({vertex, vertexSolution});
     }
     return ValidityWitness(std::move(definitions));
 }
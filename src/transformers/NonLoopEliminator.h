@@ -32,7 +32,8 @@ public:
 
         void notifyRemovedVertex(SymRef sym, Entry edges);
     private:
-        std::unordered_map<SymRef, Entry, SymRefHash> removedNodes;
+        // In the order of removal; a vertex can only depend on vertices removed after it
+        std::vector<std::pair<SymRef, Entry>> removedNodes;
         Logic & logic;
         NonlinearCanonicalPredicateRepresentation predicateRepresentation;
     };
@@ -6,6 +6,8 @@
 
 #include "SimpleChainSummarizer.h"
 
+#include "QueryDump.h"
+
 Transformer::TransformationResult SimpleChainSummarizer::transform(std::unique_ptr<ChcDirectedHyperGraph> graph) {
     auto translator = std::make_unique<SimpleChainBackTranslator>(logic, graph->predicateRepresentation());
     while(true) {
@@ -160,7 +162,7 @@ InvalidityWitness SimpleChainSummarizer::SimpleChainBackTranslator::translate(In
                 solver.insertFormula(logic.mkEq(var, value));
             }
             // 2ac Compute values for summarized predicates from model
-            auto res = solver.check();
+            auto res = QueryDump::check(solver, "chain.invalidity");
             if (res != s_True) { throw std::logic_error("Summarized chain should have been satisfiable!"); }
             auto model = solver.getModel();
             std::vector<PTRef> intermediatePredicateInstances;
@@ -227,6 +229,15 @@ ValidityWitness SimpleChainSummarizer::SimpleChainBackTranslator::translate(Vali
     config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
     TermUtils utils(logic);
     VersionManager manager(logic);
+    // Every predicate has its own variables, so the renamings of all vertices on the chains form one substitution
+    TermUtils::substitutions_map renamingMap;
+    for (auto const & entry : summarizedChains) {
+        for (auto const & edge : entry.first) {
+            auto target = edge.to;
+            utils.mapFromPredicate(predicateRepresentation.getTargetTermFor(target), predicateRepresentation.getSourceTermFor(target), renamingMap);
+        }
+    }
+    SubstitutionContext renaming(logic, std::move(renamingMap));
     for (auto && [chain, summary] : summarizedChains) {
         // Compute definitions for vertices on the chain using path interpolants
         MainSolver solver(logic, config, "labeler");
@@ -236,10 +247,7 @@ ValidityWitness SimpleChainSummarizer::SimpleChainBackTranslator::translate(Vali
         );
         solver.insertFormula(sourceInterpretation);
         for (auto const & edge : chain) {
-            TermUtils::substitutions_map substitutionsMap;
-            auto target = edge.to;
-            utils.mapFromPredicate(predicateRepresentation.getTargetTermFor(target), predicateRepresentation.getSourceTermFor(target), substitutionsMap);
-            PTRef updatedLabel = utils.varSubstitute(edge.fla.fla, substitutionsMap);
+            PTRef updatedLabel = renaming.apply(edge.fla.fla);
             solver.insertFormula(updatedLabel);
         }
         PTRef predicate = predicateRepresentation.getSourceTermFor(summary.to);
@@ -248,7 +256,7 @@ ValidityWitness SimpleChainSummarizer::SimpleChainBackTranslator::translate(Vali
             definitions.at(manager.sourceFormulaToBase(predicate))
         );
         solver.insertFormula(logic.mkNot(targetInterpretation));
-        auto res = solver.check();
+        auto res = QueryDump::check(solver, "chain.validity");
         if (res != s_False) {
             //throw std::logic_error("SimpleChainBackTranslator could not recompute solution!");
             std::cerr << "; SimpleChainBackTranslator could not recompute solution! Solver could not prove UNSAT!" << std::endl;
@@ -266,12 +274,12 @@ ValidityWitness SimpleChainSummarizer::SimpleChainBackTranslator::translate(Vali
         for (auto i = 0u; i < chain.size() - 1; ++i) {
             auto target = chain[i].to;
             PTRef predicate = predicateRepresentation.getSourceTermFor(target);
-            predicate = logic.getPterm(predicate).size() > 0 ? VersionManager(logic).sourceFormulaToBase(predicate) : predicate;
+            predicate = logic.getPterm(predicate).size() > 0 ? manager.sourceFormulaToBase(predicate) : predicate;
             if (definitions.count(predicate) > 0) {
                 std::cerr << "; Unexpected situation in SimpleChainBackTranslator: Predicate already has a solution!" << std::endl;
                 return ValidityWitness();
             }
-            definitions.insert({predicate, VersionManager(logic).sourceFormulaToBase(itps[i])});
+            definitions.insert({predicate, manager.sourceFormulaToBase(itps[i])});
         }
     }
     return ValidityWitness(std::move(definitions));
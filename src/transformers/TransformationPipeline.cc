@@ -7,9 +7,27 @@
 
 #include "TransformationPipeline.h"
 
+#include "Tracing.h"
+
+#include <cstdlib>
+#include <cxxabi.h>
+#include <typeinfo>
+
+namespace {
+// Readable name of the dynamic type of the object, e.g., "NonLoopEliminator", for the trace
+template<typename T>
+std::string typeName(T const & object) {
+    char const * mangled = typeid(object).name();
+    int status = 0;
+    std::unique_ptr<char, void (*)(void *)> demangled(abi::__cxa_demangle(mangled, nullptr, nullptr, &status), std::free);
+    return status == 0 and demangled ? std::string(demangled.get()) : std::string(mangled);
+}
+}
+
 Transformer::TransformationResult TransformationPipeline::transform(std::unique_ptr<ChcDirectedHyperGraph> graph) {
     BackTranslator::pipeline_t backtranslators;
     for (auto const & transformer : inner) {
+        GOLEM_TRACE_SCOPE_DETAIL("transformation", typeName(*transformer));
         auto result = transformer->transform(std::move(graph));
         graph = std::move(result.first);
         backtranslators.push_back(std::move(result.second));
@@ -20,6 +38,7 @@ Transformer::TransformationResult TransformationPipeline::transform(std::unique_
 
 InvalidityWitness TransformationPipeline::BackTranslator::translate(InvalidityWitness witness) {
     for (auto const & backtranslator : inner) {
+        GOLEM_TRACE_SCOPE_DETAIL("backtranslation", typeName(*backtranslator));
         witness = backtranslator->translate(std::move(witness));
     }
     return witness;
@@ -27,6 +46,7 @@ InvalidityWitness TransformationPipeline::BackTranslator::translate(InvalidityWi
 
 ValidityWitness TransformationPipeline::BackTranslator::translate(ValidityWitness witness) {
     for (auto const & backtranslator : inner) {
+        GOLEM_TRACE_SCOPE_DETAIL("backtranslation", typeName(*backtranslator));
         witness = backtranslator->translate(std::move(witness));
     }
     return witness;
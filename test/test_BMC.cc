@@ -7,6 +7,8 @@
 #include <gtest/gtest.h>
 #include "engine/Bmc.h"
 #include "graph/ChcGraphBuilder.h"
+#include "FreeVariables.h"
+#include "TransformationUtils.h"
 #include "Validator.h"
 
 TEST(BMC_test, test_BMC_simple) {
@@ -44,3 +46,176 @@ TEST(BMC_test, test_BMC_simple) {
     auto validationResult = Validator(logic).validate(*hypergraph, res);
     ASSERT_EQ(validationResult, Validator::Result::VALIDATED);
 }
+
+TEST(BMC_test, test_BMC_schedules) {
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    SymRef s1 = logic.declareFun("s1", logic.getSort_bool(), {logic.getSort_int()});
+    PTRef x = logic.mkIntVar("x");
+    PTRef xp = logic.mkIntVar("xp");
+    PTRef current = logic.mkUninterpFun(s1, {x});
+    PTRef next = logic.mkUninterpFun(s1, {xp});
+    ChcSystem system;
+    system.addUninterpretedPredicate(s1);
+    system.addClause( // x' = 0 => s1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic.mkEq(xp, logic.getTerm_IntZero())}, {}});
+    system.addClause( // s1(x) and x' = x + 1 => s1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic.mkEq(xp, logic.mkPlus(x, logic.getTerm_IntOne()))}, {UninterpretedPredicate{current}}}
+    );
+    system.addClause( // s1(x) and x > 5 => false
+            ChcHead{UninterpretedPredicate{logic.getTerm_false()}},
+            ChcBody{{logic.mkGt(x, logic.mkIntConst(5))}, {UninterpretedPredicate{current}}}
+    );
+    auto normalizedSystem = Normalizer(logic).normalize(system);
+    auto hypergraph = ChcGraphBuilder(logic).buildGraph(normalizedSystem);
+    ASSERT_TRUE(hypergraph->isNormalGraph());
+    auto graph = hypergraph->toNormalGraph();
+    // The shortest counterexample has depth 6, inside the blocks [4,7] of both schedules; it must be found exactly
+    std::optional<std::size_t> shortestLength;
+    for (std::string schedule : {"linear", "4", "geometric"}) {
+        Options options;
+        options.addOption(Options::LOGIC, "QF_LIA");
+        options.addOption(Options::COMPUTE_WITNESS, "true");
+        options.addOption(Options::BMC_SCHEDULE, schedule);
+        BMC bmc(logic, options);
+        auto res = bmc.solve(*graph);
+        ASSERT_EQ(res.getAnswer(), VerificationAnswer::UNSAFE);
+        auto validationResult = Validator(logic).validate(*hypergraph, res);
+        ASSERT_EQ(validationResult, Validator::Result::VALIDATED);
+        std::size_t length = res.getInvalidityWitness().getDerivation().size();
+        if (shortestLength.has_value()) {
+            EXPECT_EQ(length, shortestLength.value());
+        } else {
+            shortestLength = length;
+        }
+    }
+}
+
+TEST(BMC_test, test_BMC_invalidSchedules) {
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    for (std::string schedule : {"", "0", "-1", "fast", "99999999999999999999999999"}) {
+        Options options;
+        options.addOption(Options::BMC_SCHEDULE, schedule);
+        EXPECT_THROW(BMC(logic, options), std::invalid_argument) << "schedule " << schedule;
+    }
+}
+
+TEST(BMC_test, test_BMC_localVariablesInQuery) {
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    Options options;
+    options.addOption(Options::LOGIC, "QF_LIA");
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    SymRef s1 = logic.declareFun("s1", logic.getSort_bool(), {logic.getSort_int()});
+    PTRef x = logic.mkIntVar("x");
+    PTRef xp = logic.mkIntVar("xp");
+    PTRef y = logic.mkIntVar("y");
+    PTRef current = logic.mkUninterpFun(s1, {x});
+    PTRef next = logic.mkUninterpFun(s1, {xp});
+    ChcSystem system;
+    system.addUninterpretedPredicate(s1);
+    system.addClause( // x' = 0 => s1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic.mkEq(xp, logic.getTerm_IntZero())}, {}});
+    system.addClause( // s1(x) and x' = x + 1 => s1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic.mkEq(xp, logic.mkPlus(x, logic.getTerm_IntOne()))}, {UninterpretedPredicate{current}}}
+    );
+    system.addClause( // s1(x) and x > y and y >= 2 => false
+            ChcHead{UninterpretedPredicate{logic.getTerm_false()}},
+            ChcBody{{logic.mkAnd(logic.mkGt(x, y), logic.mkGeq(y, logic.mkIntConst(2)))}, {UninterpretedPredicate{current}}}
+    );
+    auto normalizedSystem = Normalizer(logic).normalize(system);
+    auto hypergraph = ChcGraphBuilder(logic).buildGraph(normalizedSystem);
+    ASSERT_TRUE(hypergraph->isNormalGraph());
+    auto graph = hypergraph->toNormalGraph();
+    auto ts = toTransitionSystem(*graph, logic);
+    EXPECT_EQ(ts->getQueryAuxiliaryVars().size(), 1u);
+    EXPECT_TRUE(FreeVariables::of(logic, ts->getQuery()).isSubsetOf(VariableSet(ts->getStateVars())));
+    BMC bmc(logic, options);
+    auto res = bmc.solve(*graph);
+    ASSERT_EQ(res.getAnswer(), VerificationAnswer::UNSAFE);
+    auto validationResult = Validator(logic).validate(*hypergraph, res);
+    ASSERT_EQ(validationResult, Validator::Result::VALIDATED);
+}
+
+TEST(BMC_test, test_BMC_twoLoops) {
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    Options options;
+    options.addOption(Options::LOGIC, "QF_LIA");
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    SymRef s1 = logic.declareFun("s1", logic.getSort_bool(), {logic.getSort_int()});
+    SymRef s2 = logic.declareFun("s2", logic.getSort_bool(), {logic.getSort_int()});
+    PTRef x = logic.mkIntVar("x");
+    PTRef xp = logic.mkIntVar("xp");
+    PTRef three = logic.mkIntConst(3);
+    ChcSystem system;
+    system.addUninterpretedPredicate(s1);
+    system.addUninterpretedPredicate(s2);
+    system.addClause( // x' = 0 => s1(x')
+            ChcHead{UninterpretedPredicate{logic.mkUninterpFun(s1, {xp})}},
+            ChcBody{{logic.mkEq(xp, logic.getTerm_IntZero())}, {}});
+    system.addClause( // s1(x) and x' = x + 1 => s1(x')
+            ChcHead{UninterpretedPredicate{logic.mkUninterpFun(s1, {xp})}},
+            ChcBody{{logic.mkEq(xp, logic.mkPlus(x, logic.getTerm_IntOne()))}, {UninterpretedPredicate{logic.mkUninterpFun(s1, {x})}}}
+    );
+    system.addClause( // s1(x) and x >= 3 and x' = x => s2(x')
+            ChcHead{UninterpretedPredicate{logic.mkUninterpFun(s2, {xp})}},
+            ChcBody{{logic.mkAnd(logic.mkGeq(x, three), logic.mkEq(xp, x))}, {UninterpretedPredicate{logic.mkUninterpFun(s1, {x})}}}
+    );
+    system.addClause( // s2(x) and x' = x - 1 => s2(x')
+            ChcHead{UninterpretedPredicate{logic.mkUninterpFun(s2, {xp})}},
+            ChcBody{{logic.mkEq(xp, logic.mkMinus(x, logic.getTerm_IntOne()))}, {UninterpretedPredicate{logic.mkUninterpFun(s2, {x})}}}
+    );
+    system.addClause( // s2(x) and x < 0 => false
+            ChcHead{UninterpretedPredicate{logic.getTerm_false()}},
+            ChcBody{{logic.mkLt(x, logic.getTerm_IntZero())}, {UninterpretedPredicate{logic.mkUninterpFun(s2, {x})}}}
+    );
+    auto normalizedSystem = Normalizer(logic).normalize(system);
+    auto hypergraph = ChcGraphBuilder(logic).buildGraph(normalizedSystem);
+    ASSERT_TRUE(hypergraph->isNormalGraph());
+    auto graph = hypergraph->toNormalGraph();
+    BMC bmc(logic, options);
+    auto res = bmc.solve(*graph);
+    ASSERT_EQ(res.getAnswer(), VerificationAnswer::UNSAFE);
+    auto validationResult = Validator(logic).validate(*hypergraph, res);
+    ASSERT_EQ(validationResult, Validator::Result::VALIDATED);
+}
+
+TEST(BMC_test, test_BMC_nonlinear) {
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    Options options;
+    options.addOption(Options::LOGIC, "QF_LIA");
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    SymRef p = logic.declareFun("P", logic.getSort_bool(), {logic.getSort_int()});
+    SymRef s = logic.declareFun("S", logic.getSort_bool(), {logic.getSort_int()});
+    PTRef x = logic.mkIntVar("x");
+    PTRef y = logic.mkIntVar("y");
+    PTRef xp = logic.mkIntVar("xp");
+    ChcSystem system;
+    system.addUninterpretedPredicate(p);
+    system.addUninterpretedPredicate(s);
+    system.addClause( // x' = 1 => P(x')
+            ChcHead{UninterpretedPredicate{logic.mkUninterpFun(p, {xp})}},
+            ChcBody{{logic.mkEq(xp, logic.getTerm_IntOne())}, {}});
+    system.addClause( // P(x) and x' = x + 1 => P(x')
+            ChcHead{UninterpretedPredicate{logic.mkUninterpFun(p, {xp})}},
+            ChcBody{{logic.mkEq(xp, logic.mkPlus(x, logic.getTerm_IntOne()))}, {UninterpretedPredicate{logic.mkUninterpFun(p, {x})}}}
+    );
+    system.addClause( // P(x) and P(y) and x' = x + y => S(x')
+            ChcHead{UninterpretedPredicate{logic.mkUninterpFun(s, {xp})}},
+            ChcBody{{logic.mkEq(xp, logic.mkPlus(x, y))}, {UninterpretedPredicate{logic.mkUninterpFun(p, {x})}, UninterpretedPredicate{logic.mkUninterpFun(p, {y})}}}
+    );
+    system.addClause( // S(x) and x = 5 => false
+            ChcHead{UninterpretedPredicate{logic.getTerm_false()}},
+            ChcBody{{logic.mkEq(x, logic.mkIntConst(5))}, {UninterpretedPredicate{logic.mkUninterpFun(s, {x})}}}
+    );
+    auto normalizedSystem = Normalizer(logic).normalize(system);
+    auto hypergraph = ChcGraphBuilder(logic).buildGraph(normalizedSystem);
+    ASSERT_FALSE(hypergraph->isNormalGraph());
+    BMC bmc(logic, options);
+    auto res = bmc.solve(*hypergraph);
+    ASSERT_EQ(res.getAnswer(), VerificationAnswer::UNSAFE);
+    auto validationResult = Validator(logic).validate(*hypergraph, res);
+    ASSERT_EQ(validationResult, Validator::Result::VALIDATED);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "SmallVector.h"
+#include "graph/ChcGraph.h"
+
+#include <vector>
+
+TEST(SmallVector_Test, test_InlineAndGrown) {
+    SmallVector<int, 2> small{1, 2};
+    EXPECT_EQ(small.size(), 2);
+    EXPECT_EQ(small.capacity(), 2);
+    small.push_back(3);
+    small.push_back(small[0]);
+    ASSERT_EQ(small.size(), 4);
+    EXPECT_GT(small.capacity(), 2);
+    EXPECT_EQ(small[2], 3);
+    EXPECT_EQ(small[3], 1);
+}
+
+TEST(SmallVector_Test, test_CopyAndMove) {
+    SmallVector<int, 2> inlined{7};
+    SmallVector<int, 2> grown{1, 2, 3};
+    SmallVector<int, 2> copy = grown;
+    EXPECT_EQ(copy, grown);
+    SmallVector<int, 2> moved = std::move(copy);
+    EXPECT_EQ(moved, grown);
+    EXPECT_TRUE(copy.empty());
+    SmallVector<int, 2> movedInline = std::move(inlined);
+    ASSERT_EQ(movedInline.size(), 1);
+    EXPECT_EQ(movedInline[0], 7);
+    movedInline = grown;
+    EXPECT_EQ(movedInline, grown);
+    EXPECT_NE(movedInline, SmallVector<int, 2>{});
+}
+
+TEST(EdgeStore_Test, test_Tombstones) {
+    struct Edge { int value; };
+    EdgeStore<Edge> store;
+    for (std::size_t i = 0; i < 10; ++i) {
+        store.emplace(EId{i}, Edge{static_cast<int>(i)});
+    }
+    Edge const & kept = store.at(EId{1});
+    store.erase(EId{0});
+    store.eraseIf([](Edge const & edge) { return edge.value % 2 == 0; });
+    EXPECT_EQ(store.size(), 5);
+    EXPECT_FALSE(store.contains(EId{4}));
+    EXPECT_THROW(store.at(EId{4}), std::out_of_range);
+    store.emplace(EId{10}, Edge{11});
+    // References stay valid when edges are added
+    EXPECT_EQ(kept.value, 1);
+    std::vector<int> visited;
+    for (auto const & edge : store) {
+        visited.push_back(edge.value);
+    }
+    EXPECT_EQ(visited, (std::vector<int>{1, 3, 5, 7, 9, 11}));
+}
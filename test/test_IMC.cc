@@ -115,4 +115,57 @@ TEST_F(IMCTest, test_IMC_moreInductionBackward_safe) {
     };
     IMC engine(*logic, options);
     solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
-}
\ No newline at end of file
+}
+
+TEST_F(IMCTest, test_ISMC_simple) {
+    Options options;
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, IMC::INTERPOLATION_SEQUENCES);
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    std::vector<ChClause> clauses {
+        { // x' = 0 => s1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        { // s1(x) and x' = x + 1 => s1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {UninterpretedPredicate{current}}}
+        },
+        { // s1(x) and x > 1 => false
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkGt(x, one)}, {UninterpretedPredicate{current}}}
+        }
+    };
+    IMC engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
+}
+
+TEST_F(IMCTest, test_ISMC_moreInductionForward_safe) {
+    Options options;
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, IMC::INTERPOLATION_SEQUENCES);
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    // x = 0 => S1(x)
+    // S1(x) and x' = ite(x = 10, 0, x + 1) => S1(x')
+    // S1(x) and x = 15 => false
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, logic->mkIte(logic->mkEq(x, logic->mkIntConst(10)), zero, logic->mkPlus(x, one)))}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(x, logic->mkIntConst(15))}, {UninterpretedPredicate{current}}}
+        }
+    };
+    IMC engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
@@ -6,6 +6,8 @@
 
 #include "TestTemplate.h"
 #include "engine/Kind.h"
+#include "TermUtils.h"
+#include "TransformationUtils.h"
 
 
 class KindTest : public LIAEngineTest {
@@ -91,4 +93,150 @@ TEST_F(KindTest, test_KIND_moreInductionBackward_safe)
         }};
     Kind engine(*logic, options);
     solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
-}
\ No newline at end of file
+}
+
+TEST_F(KindTest, test_KIND_auxiliaryInvariants_safe)
+{
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::KIND_AUX_INVARIANTS, "true");
+    PTRef y = mkIntVar("y");
+    PTRef yp = mkIntVar("yp");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort(), intSort()});
+    PTRef current = instantiatePredicate(s1, {x, y});
+    PTRef next = instantiatePredicate(s1, {xp, yp});
+    // x = 0 and y = 0 => S1(x,y)
+    // S1(x,y) and x' = x + 1 and y' = y + 1 => S1(x',y')
+    // S1(x,y) and x = -1 => false
+    // Not k-inductive for any k, but the interval invariant x >= 0 makes it 0-inductive
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkAnd(logic->mkEq(xp, zero), logic->mkEq(yp, zero))}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkAnd(logic->mkEq(xp, logic->mkPlus(x, one)), logic->mkEq(yp, logic->mkPlus(y, one)))}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(x, logic->mkIntConst(-1))}, {UninterpretedPredicate{current}}}
+        }};
+    Kind engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
+
+TEST_F(KindTest, test_KIND_simplePath_safe)
+{
+    options.addOption(Options::KIND_SIMPLE_PATH, "true");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    PTRef minusOne = logic->mkIntConst(-1);
+    PTRef minusTwo = logic->mkIntConst(-2);
+    // x = 0 => S1(x)
+    // S1(x) and ((x >= 0 and x' = x + 1) or (x = -1 and (x' = -1 or x' = -2))) => S1(x')
+    // S1(x) and x = -2 => false
+    // The unreachable state -1 stutters before reaching -2, only simple paths make the property k-inductive
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkOr(
+                logic->mkAnd(logic->mkGeq(x, zero), logic->mkEq(xp, logic->mkPlus(x, one))),
+                logic->mkAnd(logic->mkEq(x, minusOne), logic->mkOr(logic->mkEq(xp, minusOne), logic->mkEq(xp, minusTwo)))
+            )}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(x, minusTwo)}, {UninterpretedPredicate{current}}}
+        }};
+    Kind engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, false);
+}
+
+class KinductiveInvariantTest : public KindTest {
+protected:
+    // x = 0 => S1(x)
+    // S1(x) and x' = ite(x = 2, 0, x + 1) => S1(x')
+    // S1(x) and x = 5 => false
+    // The unreachable states 3 and 4 lead to 5, so the property is 3-inductive, but not 2-inductive
+    std::vector<ChClause> threeInductiveClauses() {
+        SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+        PTRef current = instantiatePredicate(s1, {x});
+        PTRef next = instantiatePredicate(s1, {xp});
+        return {
+            {
+                ChcHead{UninterpretedPredicate{next}},
+                ChcBody{{logic->mkEq(xp, zero)}, {}}
+            },
+            {
+                ChcHead{UninterpretedPredicate{next}},
+                ChcBody{{logic->mkEq(xp, logic->mkIte(logic->mkEq(x, two), zero, logic->mkPlus(x, one)))}, {UninterpretedPredicate{current}}}
+            },
+            {
+                ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+                ChcBody{{logic->mkEq(x, logic->mkIntConst(5))}, {UninterpretedPredicate{current}}}
+            }};
+    }
+
+    std::unique_ptr<TransitionSystem> toSystem(std::vector<ChClause> const & clauses) {
+        for (auto const & clause : clauses) { system.addClause(clause); }
+        auto normalizedSystem = Normalizer(*logic).normalize(system);
+        auto hypergraph = ChcGraphBuilder(*logic).buildGraph(normalizedSystem);
+        EXPECT_TRUE(hypergraph->isNormalGraph());
+        return toTransitionSystem(*hypergraph->toNormalGraph(), *logic);
+    }
+
+    bool isUnsat(PTRef fla) {
+        SMTConfig config;
+        MainSolver solver(*logic, config, "test");
+        solver.insertFormula(fla);
+        return solver.check() == s_False;
+    }
+
+    bool isKinductive(PTRef invariant, unsigned long k, TransitionSystem const & ts) {
+        TimeMachine tm(*logic);
+        vec<PTRef> path;
+        for (unsigned long i = 0; i < k; ++i) {
+            path.push(tm.sendFlaThroughTime(invariant, static_cast<int>(i)));
+            path.push(tm.sendFlaThroughTime(ts.getTransition(), static_cast<int>(i)));
+        }
+        path.push(logic->mkNot(tm.sendFlaThroughTime(invariant, static_cast<int>(k))));
+        return isUnsat(logic->mkAnd(std::move(path)));
+    }
+
+    void expectSafeInductiveInvariant(PTRef invariant, TransitionSystem const & ts) {
+        EXPECT_TRUE(isUnsat(logic->mkAnd(ts.getInit(), logic->mkNot(invariant))));
+        EXPECT_TRUE(isKinductive(invariant, 1, ts));
+        EXPECT_TRUE(isUnsat(logic->mkAnd(invariant, ts.getQuery())));
+    }
+};
+
+TEST_F(KinductiveInvariantTest, test_KIND_threeInductive_safe)
+{
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    Kind engine(*logic, options);
+    solveSystem(threeInductiveClauses(), engine, VerificationAnswer::SAFE, true);
+}
+
+TEST_F(KinductiveInvariantTest, test_KinductiveToInductive_Interpolation)
+{
+    auto ts = toSystem(threeInductiveClauses());
+    PTRef property = logic->mkNot(ts->getQuery());
+    ASSERT_FALSE(isKinductive(property, 2, *ts));
+    ASSERT_TRUE(isKinductive(property, 3, *ts));
+    auto inductive = kinductiveToInductiveByInterpolation(property, 3, *ts);
+    ASSERT_TRUE(inductive.has_value());
+    expectSafeInductiveInvariant(inductive.value(), *ts);
+    expectSafeInductiveInvariant(kinductiveToInductive(property, 3, *ts), *ts);
+}
+
+TEST_F(KinductiveInvariantTest, test_KinductiveToInductive_QuantifierElimination)
+{
+    auto ts = toSystem(threeInductiveClauses());
+    PTRef property = logic->mkNot(ts->getQuery());
+    expectSafeInductiveInvariant(kinductiveToInductiveByQE(property, 3, *ts), *ts);
+}
@@ -6,6 +6,7 @@
 
 #include "TestTemplate.h"
 #include "engine/Lawi.h"
+#include "InterpolationSelection.h"
 
 class LAWI_LRA_Test : public LRAEngineTest {
 };
@@ -266,3 +267,109 @@ TEST_F(LAWI_LIA_Test, test_LAWI_zeroary_predicate) {
     Lawi engine(*logic, options);
     solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
 }
+
+class LAWI_Diamond_Test : public LIAEngineTest {
+protected:
+    SymRef l, a, b, c;
+
+    LAWI_Diamond_Test() {
+        options.addOption(Options::COMPUTE_WITNESS, "true");
+        l = mkPredicateSymbol("l", {intSort()});
+        a = mkPredicateSymbol("a", {intSort()});
+        b = mkPredicateSymbol("b", {intSort()});
+        c = mkPredicateSymbol("c", {intSort()});
+    }
+
+    UninterpretedPredicate pred(SymRef sym, PTRef var) { return UninterpretedPredicate{instantiatePredicate(sym, {var})}; }
+
+    // Loop with a diamond in its body: L(x) branches to A(x) or B(x), both join in C(x) which returns to L(x)
+    std::vector<ChClause> loopWithDiamond() {
+        PTRef five = logic->mkIntConst(5);
+        return {
+            { ChcHead{pred(l, xp)}, ChcBody{{logic->mkEq(xp, zero)}, {}} },
+            { ChcHead{pred(a, x)}, ChcBody{{logic->mkLt(x, five)}, {pred(l, x)}} },
+            { ChcHead{pred(b, x)}, ChcBody{{logic->mkGeq(x, five)}, {pred(l, x)}} },
+            { ChcHead{pred(c, xp)}, ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {pred(a, x)}} },
+            { ChcHead{pred(c, xp)}, ChcBody{{logic->mkEq(xp, logic->mkPlus(x, two))}, {pred(b, x)}} },
+            { ChcHead{pred(l, x)}, ChcBody{{logic->getTerm_true()}, {pred(c, x)}} }
+        };
+    }
+
+    // C(x) and x < 0 => false
+    ChClause safeQuery() {
+        return {ChcHead{UninterpretedPredicate{logic->getTerm_false()}}, ChcBody{{logic->mkLt(x, zero)}, {pred(c, x)}}};
+    }
+
+    // C(x) and x = 7 => false, reachable only through the second branch
+    ChClause unsafeQuery() {
+        return {ChcHead{UninterpretedPredicate{logic->getTerm_false()}}, ChcBody{{logic->mkEq(x, logic->mkIntConst(7))}, {pred(c, x)}}};
+    }
+};
+
+class LAWI_BlockEncoding_Test : public LAWI_Diamond_Test {
+protected:
+    LAWI_BlockEncoding_Test() {
+        options.addOption(Options::LAWI_BLOCK_ENCODING, "true");
+    }
+};
+
+TEST_F(LAWI_BlockEncoding_Test, test_LAWI_blockEncoding_safe) {
+    auto clauses = loopWithDiamond();
+    clauses.push_back(safeQuery());
+    Lawi engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
+
+TEST_F(LAWI_BlockEncoding_Test, test_LAWI_blockEncoding_unsafe) {
+    auto clauses = loopWithDiamond();
+    clauses.push_back(unsafeQuery());
+    Lawi engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
+}
+
+class LAWI_ItpSelection_Test : public LAWI_Diamond_Test, public ::testing::WithParamInterface<char const *> {
+protected:
+    LAWI_ItpSelection_Test() {
+        options.addOption(Options::LRA_ITP_ALG, GetParam());
+    }
+};
+
+TEST_P(LAWI_ItpSelection_Test, test_LAWI_itpSelection_safe) {
+    auto clauses = loopWithDiamond();
+    clauses.push_back(safeQuery());
+    Lawi engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
+
+TEST_P(LAWI_ItpSelection_Test, test_LAWI_itpSelection_unsafe) {
+    auto clauses = loopWithDiamond();
+    clauses.push_back(unsafeQuery());
+    Lawi engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
+}
+
+INSTANTIATE_TEST_SUITE_P(LAWI, LAWI_ItpSelection_Test, ::testing::Values("adaptive", "smallest"));
+
+TEST(InterpolationAlgorithmSelector_Test, test_AdaptiveTriesEveryArmFirst) {
+    Options options;
+    options.addOption(Options::LRA_ITP_ALG, "adaptive");
+    InterpolationAlgorithmSelector selector(options);
+    ASSERT_EQ(selector.getMode(), InterpolationAlgorithmSelector::Mode::ADAPTIVE);
+    ASSERT_GT(selector.armCount(), 1);
+    std::size_t const best = selector.armCount() / 2;
+    for (std::size_t arm = 0; arm < selector.armCount(); ++arm) {
+        EXPECT_EQ(selector.select(), arm);
+        selector.reward(arm, arm == best ? 1.0 : 0.0);
+    }
+    // Every arm has been tried once, the only rewarded one is exploited
+    EXPECT_EQ(selector.select(), best);
+}
+
+TEST(InterpolationAlgorithmSelector_Test, test_FixedAlgorithm) {
+    Options options;
+    options.addOption(Options::LRA_ITP_ALG, "2");
+    InterpolationAlgorithmSelector selector(options);
+    EXPECT_EQ(selector.getMode(), InterpolationAlgorithmSelector::Mode::FIXED);
+    EXPECT_EQ(selector.armCount(), 1);
+    EXPECT_EQ(selector.select(), 0);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "Progress.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Progress_Test : public ::testing::Test {
+protected:
+    std::mutex mutex;
+    std::vector<std::uint64_t> delivered;
+
+    void enable(double interval) {
+        Progress::enable([this](Progress::Report const & report) {
+            std::lock_guard<std::mutex> lock(mutex);
+            delivered.push_back(report.safeBound.value());
+        }, interval);
+    }
+
+    std::vector<std::uint64_t> deliveredBounds() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return delivered;
+    }
+
+    void TearDown() override { Progress::disable(); }
+};
+
+TEST_F(Progress_Test, test_ZeroIntervalDeliversEverything) {
+    enable(0);
+    for (std::uint64_t bound = 1; bound <= 3; ++bound) {
+        Progress::report("test", bound, std::nullopt);
+    }
+    EXPECT_EQ(deliveredBounds(), (std::vector<std::uint64_t>{1, 2, 3}));
+}
+
+TEST_F(Progress_Test, test_SuppressedReportsAreCoalesced) {
+    enable(0.1);
+    for (std::uint64_t bound = 10; bound <= 1000; ++bound) {
+        Progress::report("test", bound, std::nullopt);
+    }
+    // The first report goes out immediately, the newest one when the interval has passed, without another report
+    EXPECT_EQ(deliveredBounds(), std::vector<std::uint64_t>{10});
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_EQ(deliveredBounds(), (std::vector<std::uint64_t>{10, 1000}));
+}
+
+TEST_F(Progress_Test, test_DisableDeliversPendingReport) {
+    enable(60);
+    Progress::report("test", 1, std::nullopt);
+    Progress::report("test", 2, std::nullopt);
+    Progress::disable();
+    EXPECT_EQ(deliveredBounds(), (std::vector<std::uint64_t>{1, 2}));
+}
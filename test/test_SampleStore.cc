@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "SampleStore.h"
+
+class SampleStore_Test : public ::testing::Test {
+protected:
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    PTRef x;
+    PTRef y;
+    PTRef zero;
+    PTRef one;
+
+    SampleStore_Test() {
+        x = logic.mkIntVar("x");
+        y = logic.mkIntVar("y");
+        zero = logic.getTerm_IntZero();
+        one = logic.getTerm_IntOne();
+    }
+
+    std::unique_ptr<Model> modelOf(PTRef fla) {
+        SMTConfig config;
+        MainSolver solver(logic, config, "sample");
+        solver.insertFormula(fla);
+        auto res = solver.check();
+        EXPECT_EQ(res, s_True);
+        return solver.getModel();
+    }
+};
+
+TEST_F(SampleStore_Test, test_Refutation) {
+    SampleSet samples(logic);
+    samples.addSample(modelOf(logic.mkAnd(logic.mkEq(x, one), logic.mkEq(y, zero))));
+    // x > 0 does not imply y > 0
+    EXPECT_TRUE(samples.refutes(logic.mkGt(x, zero), logic.mkGt(y, zero)));
+    // x > 0 implies x >= 0, no sample can refute it
+    EXPECT_FALSE(samples.refutes(logic.mkGt(x, zero), logic.mkGeq(x, zero)));
+}
+
+TEST_F(SampleStore_Test, test_SampleMustSatisfyAntecedent) {
+    SampleSet samples(logic);
+    samples.addSample(modelOf(logic.mkAnd(logic.mkEq(x, one), logic.mkEq(y, zero))));
+    // The sample falsifies the consequent, but it does not satisfy the antecedent
+    EXPECT_FALSE(samples.refutes(logic.mkLt(x, zero), logic.mkGt(y, zero)));
+}
+
+TEST_F(SampleStore_Test, test_SamplesArePerPredicate) {
+    SymRef p = logic.declareFun("P", logic.getSort_bool(), {logic.getSort_int()});
+    SymRef q = logic.declareFun("Q", logic.getSort_bool(), {logic.getSort_int()});
+    SampleStore store(logic);
+    store.addSample(p, modelOf(logic.mkEq(x, one)));
+    EXPECT_TRUE(store.refutes(p, logic.getTerm_true(), logic.mkLeq(x, zero)));
+    EXPECT_FALSE(store.refutes(q, logic.getTerm_true(), logic.mkLeq(x, zero)));
+}
+
+TEST_F(SampleStore_Test, test_CapacityIsRespected) {
+    SampleSet samples(logic, 1);
+    samples.addSample(modelOf(logic.mkEq(x, zero)));
+    samples.addSample(modelOf(logic.mkEq(x, one)));
+    EXPECT_EQ(samples.size(), 1);
+    // Only the newest sample is kept
+    EXPECT_TRUE(samples.refutes(logic.getTerm_true(), logic.mkEq(x, zero)));
+    EXPECT_FALSE(samples.refutes(logic.getTerm_true(), logic.mkEq(x, one)));
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "SyntacticImplication.h"
+
+class SyntacticImplication_Test : public ::testing::Test {
+protected:
+    ArithLogic logic {opensmt::Logic_t::QF_LRA};
+    SyntacticImplication checker {logic};
+    PTRef x;
+    PTRef y;
+    PTRef a;
+    PTRef b;
+
+    SyntacticImplication_Test() {
+        x = logic.mkRealVar("x");
+        y = logic.mkRealVar("y");
+        a = logic.mkBoolVar("a");
+        b = logic.mkBoolVar("b");
+    }
+
+    PTRef num(int val) { return logic.mkRealConst(val); }
+};
+
+TEST_F(SyntacticImplication_Test, test_Trivial) {
+    EXPECT_TRUE(checker.isValid(a, a));
+    EXPECT_TRUE(checker.isValid(logic.getTerm_false(), a));
+    EXPECT_TRUE(checker.isValid(a, logic.getTerm_true()));
+}
+
+TEST_F(SyntacticImplication_Test, test_ConjunctContainment) {
+    EXPECT_TRUE(checker.isValid(logic.mkAnd(a, b), a));
+    EXPECT_TRUE(checker.isValid(logic.mkAnd({a, b, logic.mkLeq(x, y)}), logic.mkAnd(logic.mkLeq(x, y), b)));
+    EXPECT_FALSE(checker.isValid(a, logic.mkAnd(a, b)));
+}
+
+TEST_F(SyntacticImplication_Test, test_Bounds) {
+    EXPECT_TRUE(checker.isValid(logic.mkLeq(x, num(3)), logic.mkLeq(x, num(5))));
+    EXPECT_TRUE(checker.isValid(logic.mkLt(x, num(3)), logic.mkLt(x, num(3))));
+    EXPECT_TRUE(checker.isValid(logic.mkLt(x, num(3)), logic.mkLeq(x, num(3))));
+    EXPECT_TRUE(checker.isValid(logic.mkGeq(x, num(3)), logic.mkGt(x, num(2))));
+    EXPECT_FALSE(checker.isValid(logic.mkLeq(x, num(5)), logic.mkLeq(x, num(3))));
+    EXPECT_FALSE(checker.isValid(logic.mkLeq(x, num(3)), logic.mkLeq(y, num(5))));
+}
+
+TEST_F(SyntacticImplication_Test, test_Octagon) {
+    PTRef diff = logic.mkMinus(x, y);
+    EXPECT_TRUE(checker.isValid(logic.mkLeq(diff, num(1)), logic.mkLeq(diff, num(2))));
+}
+
+TEST_F(SyntacticImplication_Test, test_InconsistentAntecedent) {
+    EXPECT_TRUE(checker.isValid(logic.mkAnd(logic.mkLeq(x, num(1)), logic.mkGeq(x, num(2))), a));
+}
+
+TEST_F(SyntacticImplication_Test, test_Disjunctions) {
+    PTRef antecedent = logic.mkOr(logic.mkAnd(a, logic.mkLeq(x, num(0))), logic.mkAnd(b, logic.mkLeq(x, num(1))));
+    EXPECT_TRUE(checker.isValid(antecedent, logic.mkLeq(x, num(2))));
+    EXPECT_FALSE(checker.isValid(antecedent, a));
+    EXPECT_TRUE(checker.isValid(a, logic.mkOr(a, b)));
+}
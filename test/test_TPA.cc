@@ -286,4 +286,32 @@ TEST_F(TPATest, test_transformContractVertex) {
     TPAEngine engine(*logic, options);
     // FIXME: Enable validation when TPA can compute witnesses for chains
     solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
-}
\ No newline at end of file
+}
+
+TEST_F(TPATest, test_TPA_threeInductive_safe)
+{
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, TPAEngine::SPLIT_TPA);
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    // x = 0 => S1(x)
+    // S1(x) and x' = ite(x = 2, 0, x + 1) => S1(x')
+    // S1(x) and x = 5 => false
+    // The invariant from the fixed point of the exact relation is only k-inductive and must be made inductive
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, logic->mkIte(logic->mkEq(x, two), zero, logic->mkPlus(x, one)))}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(x, logic->mkIntConst(5))}, {UninterpretedPredicate{current}}}
+        }};
+    TPAEngine engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
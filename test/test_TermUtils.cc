@@ -111,4 +111,47 @@ TEST_F(TermUtils_Test, test_TopLevelDisjuncts_NestedTwoLevels) {
     EXPECT_TRUE(contains(disjunctions, na));
     EXPECT_TRUE(contains(disjunctions, nb));
     EXPECT_TRUE(contains(disjunctions, nc));
-}
\ No newline at end of file
+}
+
+TEST_F(TermUtils_Test, test_GetVars_CachedAndUncachedAgree) {
+    PTRef shared = logic.mkAnd(a, nb);
+    PTRef fla = logic.mkOr(logic.mkAnd(shared, c), logic.mkNot(shared));
+    auto uncached = utils.getVars(fla);
+    FreeVariables::Registration registration(logic);
+    auto cached = utils.getVars(fla);
+    ASSERT_EQ(cached.size(), 3);
+    ASSERT_EQ(uncached.size(), cached.size());
+    for (int i = 0; i < cached.size(); ++i) {
+        EXPECT_EQ(cached[i], uncached[i]);
+    }
+    EXPECT_EQ(utils.getVars(shared).size(), 2);
+    EXPECT_TRUE(contains(utils.getVars(shared), b));
+}
+
+TEST_F(TermUtils_Test, test_VariableSet_Operations) {
+    VariableSet ab(std::vector<PTRef>{b, a, b});
+    VariableSet bc(std::vector<PTRef>{c, b});
+    EXPECT_EQ(ab.size(), 2);
+    EXPECT_TRUE(ab.contains(a));
+    EXPECT_FALSE(ab.contains(c));
+    EXPECT_EQ(ab.unite(bc).size(), 3);
+    auto common = ab.intersect(bc);
+    ASSERT_EQ(common.size(), 1);
+    EXPECT_TRUE(common.contains(b));
+    auto onlyA = ab.minus(bc);
+    ASSERT_EQ(onlyA.size(), 1);
+    EXPECT_TRUE(onlyA.contains(a));
+    EXPECT_TRUE(onlyA.isSubsetOf(ab));
+    EXPECT_FALSE(ab.isSubsetOf(bc));
+}
+
+TEST_F(TermUtils_Test, test_SubstitutionContext_ExtendedMap) {
+    PTRef shared = logic.mkAnd(a, nb);
+    SubstitutionContext context(logic, {{a, c}});
+    auto results = context.apply(std::vector<PTRef>{shared, logic.mkOr(shared, b)});
+    EXPECT_EQ(results[0], logic.mkAnd(c, nb));
+    EXPECT_EQ(results[1], logic.mkOr(logic.mkAnd(c, nb), b));
+    context.extend({{b, a}});
+    EXPECT_EQ(context.apply(shared), logic.mkAnd(c, logic.mkNot(a)));
+    EXPECT_EQ(context.apply(logic.mkOr(shared, b)), utils.varSubstitute(logic.mkOr(shared, b), {{a, c}, {b, a}}));
+}
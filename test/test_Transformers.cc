@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 #include "graph/ChcGraphBuilder.h"
+#include "transformers/GraphReverser.h"
 #include "transformers/SimpleChainSummarizer.h"
 #include "Validator.h"
 #include "engine/Spacer.h"
@@ -302,3 +303,60 @@ TEST_F(Transformer_test, test_ChainSummarizer_SameChainTwice_DifferentFact_Unsaf
     ASSERT_EQ(validator.validate(originalGraph, result), Validator::Result::VALIDATED);
 }
 
+TEST_F(Transformer_test, test_GraphReverser_Safe) {
+    ChcSystem system;
+    Options options;
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    system.addUninterpretedPredicate(s1);
+    system.addClause( // x' = 0 => S1(x')
+        ChcHead{UninterpretedPredicate{nextS1}},
+        ChcBody{{logic.mkEq(xp, zero)}, {}});
+    system.addClause( // S1(x) and x' = x + 2 => S1(x')
+        ChcHead{UninterpretedPredicate{nextS1}},
+        ChcBody{{logic.mkEq(xp, logic.mkPlus(x, two))}, {UninterpretedPredicate{currentS1}}}
+    );
+    system.addClause( // S1(x) and x = 5 => false
+        ChcHead{UninterpretedPredicate{logic.getTerm_false()}},
+        ChcBody{{logic.mkEq(x, logic.mkIntConst(5))}, {UninterpretedPredicate{currentS1}}}
+    );
+    auto hypergraph = systemToGraph(system);
+    auto originalGraph = *hypergraph;
+    auto [reversedGraph, translator] = GraphReverser().transform(std::move(hypergraph));
+    auto res = Spacer(logic, options).solve(*reversedGraph);
+    ASSERT_EQ(res.getAnswer(), VerificationAnswer::SAFE);
+    Validator validator(logic);
+    ASSERT_EQ(validator.validate(*reversedGraph, res), Validator::Result::VALIDATED);
+    auto result = translator->translate(res);
+    EXPECT_EQ(validator.validate(originalGraph, result), Validator::Result::VALIDATED);
+}
+
+TEST_F(Transformer_test, test_GraphReverser_Unsafe) {
+    ChcSystem system;
+    Options options;
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    system.addUninterpretedPredicate(s1);
+    system.addUninterpretedPredicate(s2);
+    system.addClause( // x' = 0 => S1(x')
+        ChcHead{UninterpretedPredicate{nextS1}},
+        ChcBody{{logic.mkEq(xp, zero)}, {}});
+    system.addClause( // S1(x) and x' = x + 1 => S1(x')
+        ChcHead{UninterpretedPredicate{nextS1}},
+        ChcBody{{logic.mkEq(xp, logic.mkPlus(x, one))}, {UninterpretedPredicate{currentS1}}}
+    );
+    system.addClause( // S1(x) and x' = 2 * x => S2(x')
+        ChcHead{UninterpretedPredicate{nextS2}},
+        ChcBody{{logic.mkEq(xp, logic.mkTimes(x, two))}, {UninterpretedPredicate{currentS1}}}
+    );
+    system.addClause( // S2(x) and x = 4 => false
+        ChcHead{UninterpretedPredicate{logic.getTerm_false()}},
+        ChcBody{{logic.mkEq(x, logic.mkIntConst(4))}, {UninterpretedPredicate{currentS2}}}
+    );
+    auto hypergraph = systemToGraph(system);
+    auto originalGraph = *hypergraph;
+    auto [reversedGraph, translator] = GraphReverser().transform(std::move(hypergraph));
+    auto res = Spacer(logic, options).solve(*reversedGraph);
+    ASSERT_EQ(res.getAnswer(), VerificationAnswer::UNSAFE);
+    Validator validator(logic);
+    auto result = translator->translate(res);
+    EXPECT_EQ(validator.validate(originalGraph, result), Validator::Result::VALIDATED);
+}